@@ -1,7 +1,7 @@
 //
 //    FILE: I2C_eeprom.cpp
 //  AUTHOR: Rob Tillaart
-// VERSION: 1.3.1
+// VERSION: 1.4.0
 // PURPOSE: Arduino Library for external I2C EEPROM 24LC256 et al.
 //     URL: https://github.com/RobTillaart/I2C_EEPROM.git
 //
@@ -31,19 +31,45 @@
 // 1.2.7    2019-09-03  fix issue #113 and #128
 // 1.3.0    2020-06-19  refactor; removed pre 1.0 support; added ESP32 support.
 // 1.3.1    2020-12-22  arduino-ci + unit tests + updateByte()
+// 1.4.0    2026-10-18  added updateBlock() + typed accessors
+//                      fix single parameter constructor + page size guess,
+//                      added erase(), copyBlock()
+//                      larger TWI buffer on ESP, SAMD and RP2040
+//                      no ACK polling when no write is pending
+//                      optional write counting per page (I2C_eeprom_wear)
+//                      added setFRAM()
+//                      added setClock(), probeClock()
+//                      added setBusHold()
+//                      added isReady()
 
 
 #include <I2C_eeprom.h>
+#include <I2C_eeprom_wear.h>
+
+// max duration of a write cycle in micros
+#define I2C_WRITEDELAY  5000
 
 
 I2C_eeprom::I2C_eeprom(const uint8_t deviceAddress)
+    : I2C_eeprom(deviceAddress, I2C_DEVICESIZE_24LC256)
 {
-    I2C_eeprom(deviceAddress, I2C_EEPROM_PAGESIZE);
 }
 
-I2C_eeprom::I2C_eeprom(const uint8_t deviceAddress, const unsigned int deviceSize)
+I2C_eeprom::I2C_eeprom(const uint8_t deviceAddress, const uint32_t deviceSize)
 {
     _deviceAddress = deviceAddress;
+    _deviceSize = deviceSize;
+    _progress = NULL;
+    _wear = NULL;
+    _isFRAM = false;
+    _clock = 0;
+    _busClock = 0;
+    _clockApplied = false;
+    _holdBytes = 0;
+    _holdMicros = 0;
+    _holdHook = NULL;
+    _lastWrite = 0;
+    _writePending = true;   // a write may be in progress after a reset
 
     // Chips 16Kbit (2048 Bytes) or smaller only have one-word addresses.
     // Also try to guess page size from device size (going by Microchip 24LCXX datasheets here).
@@ -57,12 +83,12 @@ I2C_eeprom::I2C_eeprom(const uint8_t deviceAddress, const unsigned int deviceSiz
         this->_isAddressSizeTwoWords = false;
         this->_pageSize = 16;
     }
-    else if(deviceSize <= 8192 * 8)
+    else if(deviceSize <= I2C_DEVICESIZE_24LC64)
     {
         this->_isAddressSizeTwoWords = true;
         this->_pageSize = 32;
     }
-    else if(deviceSize <= 65536 * 8)
+    else if(deviceSize <= I2C_DEVICESIZE_24LC256)
     {
         this->_isAddressSizeTwoWords = true;
         this->_pageSize = 64;
@@ -79,6 +105,8 @@ void I2C_eeprom::begin(uint8_t sda, uint8_t scl)
 {
   Wire.begin(sda, scl);
   _lastWrite = 0;
+  // a write may be in progress after a reset, FRAM has no write cycle
+  _writePending = !_isFRAM;
 }
 #endif
 
@@ -86,6 +114,8 @@ void I2C_eeprom::begin()
 {
   Wire.begin();
   _lastWrite = 0;
+  // a write may be in progress after a reset, FRAM has no write cycle
+  _writePending = !_isFRAM;
 }
 
 int I2C_eeprom::writeByte(const uint16_t memoryAddress, const uint8_t data)
@@ -96,12 +126,13 @@ int I2C_eeprom::writeByte(const uint16_t memoryAddress, const uint8_t data)
 
 int I2C_eeprom::setBlock(const uint16_t memoryAddress, const uint8_t data, const uint16_t length)
 {
-  uint8_t buffer[I2C_TWIBUFFERSIZE];
-  for (uint8_t i = 0; i < I2C_TWIBUFFERSIZE; i++)
-  {
-    buffer[i] = data;
-  }
-  int rv = _pageBlock(memoryAddress, buffer, length, false);
+  int rv = _fillBlock(memoryAddress, data, length, false);
+  return rv;
+}
+
+int I2C_eeprom::erase(const uint16_t memoryAddress, const uint32_t length, const uint8_t value)
+{
+  int rv = _fillBlock(memoryAddress, value, length, true);
   return rv;
 }
 
@@ -123,10 +154,12 @@ uint16_t I2C_eeprom::readBlock(const uint16_t memoryAddress, uint8_t* buffer, co
   uint16_t addr = memoryAddress;
   uint16_t len = length;
   uint16_t rv = 0;
+  _startHold();
   while (len > 0)
   {
     uint8_t cnt = I2C_TWIBUFFERSIZE;
     if (cnt > len) cnt = len;
+    _checkHold(cnt);
     rv     += _ReadBlock(addr, buffer, cnt);
     addr   += cnt;
     buffer += cnt;
@@ -141,8 +174,164 @@ int I2C_eeprom::updateByte(const uint16_t memoryAddress, const uint8_t data)
   if (data == readByte(memoryAddress)) return 0;
   return writeByte(memoryAddress, data);
 }
+
+// compares per chunk that does not cross a page boundary,
+// so every changed chunk costs at most one write cycle.
+int I2C_eeprom::updateBlock(const uint16_t memoryAddress, const uint8_t* buffer, const uint16_t length)
+{
+  uint16_t addr = memoryAddress;
+  uint16_t len = length;
+  uint8_t  current[I2C_TWIBUFFERSIZE];
+  _startHold();
+  while (len > 0)
+  {
+    uint8_t bytesUntilPageBoundary = _bytesUntilPageBoundary(addr);
+
+    uint8_t cnt = I2C_TWIBUFFERSIZE;
+    if (cnt > len) cnt = len;
+    if (cnt > bytesUntilPageBoundary) cnt = bytesUntilPageBoundary;
+    _checkHold(cnt);
+
+    if ((_ReadBlock(addr, current, cnt) != cnt) || (memcmp(current, buffer, cnt) != 0))
+    {
+      int rv = _WriteBlock(addr, buffer, cnt);
+      if (rv != 0) return rv;
+    }
+
+    addr   += cnt;
+    buffer += cnt;
+    len    -= cnt;
+  }
+  return 0;
+}
+
   
-  
+int I2C_eeprom::copyBlock(const uint16_t source, const uint16_t destination, const uint16_t length)
+{
+  return copyBlock(source, *this, destination, length);
+}
+
+// Chunks are aligned to the page boundaries of the target so every chunk
+// is one write cycle. _WriteBlock() returns as soon as the data is sent,
+// so for another device the next _ReadBlock() runs during the write cycle
+// of the target, the wait is done by the next target._WriteBlock().
+int I2C_eeprom::copyBlock(const uint16_t source, I2C_eeprom &target, const uint16_t destination, const uint16_t length)
+{
+  uint8_t  buffer[I2C_TWIBUFFERSIZE];
+  // same device and destination inside source => copy from the end
+  bool     backwards = (&target == this) && (destination > source) && (destination - source < length);
+  uint16_t len = length;
+  _startHold();
+  while (len > 0)
+  {
+    uint16_t src = backwards ? source + len : source + length - len;
+    uint16_t dst = backwards ? destination + len : destination + length - len;
+    uint8_t  cnt = I2C_TWIBUFFERSIZE;
+    if (cnt > len) cnt = len;
+    if (backwards)
+    {
+      uint8_t bytesFromPageBoundary = dst % target._pageSize;
+      if (bytesFromPageBoundary == 0) bytesFromPageBoundary = target._pageSize;
+      if (!target._isFRAM && cnt > bytesFromPageBoundary) cnt = bytesFromPageBoundary;
+      src -= cnt;
+      dst -= cnt;
+    }
+    else
+    {
+      uint8_t bytesUntilPageBoundary = target._bytesUntilPageBoundary(dst);
+      if (cnt > bytesUntilPageBoundary) cnt = bytesUntilPageBoundary;
+    }
+
+    _checkHold(2 * cnt);   // read and write
+    if (_ReadBlock(src, buffer, cnt) != cnt) return -1;
+    int rv = target._WriteBlock(dst, buffer, cnt);
+    if (rv != 0) return rv;
+
+    len -= cnt;
+  }
+  return 0;
+}
+
+void I2C_eeprom::setClock(const uint32_t clock, const uint32_t busClock)
+{
+  _clock = clock;
+  _busClock = busClock;
+  _clockApplied = false;
+  if (_clock != 0 && _busClock != 0) Wire.setClock(_busClock);
+}
+
+// A reference is read at 100 KHz and read again at every faster
+// clock, the highest clock that returns the same bytes is used.
+// Bytes that are all the same, e.g. an erased region, are also read
+// with a stuck data line, so they give 100 KHz. Only if the caller
+// allows it a scratch pattern is written as reference.
+uint32_t I2C_eeprom::probeClock(const uint16_t memoryAddress, const uint32_t maxClock, const bool scratch)
+{
+  const uint32_t clocks[] = { I2C_EEPROM_CLOCK_1M, I2C_EEPROM_CLOCK_400K };
+  uint8_t  reference[I2C_EEPROM_PROBE_SIZE];
+  uint8_t  buffer[I2C_EEPROM_PROBE_SIZE];
+  uint32_t best  = 0;
+  bool     valid = false;
+
+  uint32_t clock    = _clock;
+  uint32_t busClock = _busClock;
+  _clock = 0;   // no clock switching by _ReadBlock() while probing
+  Wire.setClock(I2C_EEPROM_CLOCK_100K);
+  if (scratch)
+  {
+    for (uint8_t i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) reference[i] = 0xA5 + i * 0x3B;
+    if ((writeBlock(memoryAddress, reference, I2C_EEPROM_PROBE_SIZE) == 0)
+       && (_ReadBlock(memoryAddress, buffer, I2C_EEPROM_PROBE_SIZE) == I2C_EEPROM_PROBE_SIZE))
+    {
+      best  = I2C_EEPROM_CLOCK_100K;
+      valid = (memcmp(buffer, reference, I2C_EEPROM_PROBE_SIZE) == 0);
+    }
+  }
+  else if (_ReadBlock(memoryAddress, reference, I2C_EEPROM_PROBE_SIZE) == I2C_EEPROM_PROBE_SIZE)
+  {
+    best = I2C_EEPROM_CLOCK_100K;
+    for (uint8_t i = 1; i < I2C_EEPROM_PROBE_SIZE; i++)
+    {
+      if (reference[i] != reference[0]) valid = true;
+    }
+  }
+
+  for (uint8_t i = 0; valid && (i < sizeof(clocks) / sizeof(clocks[0])); i++)
+  {
+    if (clocks[i] > maxClock) continue;
+    Wire.setClock(clocks[i]);
+    if ((_ReadBlock(memoryAddress, buffer, I2C_EEPROM_PROBE_SIZE) == I2C_EEPROM_PROBE_SIZE)
+       && (memcmp(buffer, reference, I2C_EEPROM_PROBE_SIZE) == 0))
+    {
+      best = clocks[i];
+      break;
+    }
+  }
+
+  // keep the clock of this device if the probe failed, and restore
+  // the clock of the caller: the bus clock, else the device clock.
+  setClock((best != 0) ? best : clock, busClock);
+  uint32_t restore = busClock;
+  if (restore == 0) restore = (_clock != 0) ? _clock : I2C_EEPROM_CLOCK_100K;
+  Wire.setClock(restore);
+  return best;
+}
+
+// one ACK poll instead of the loop of _waitEEReady()
+bool I2C_eeprom::isReady()
+{
+  if (!_writePending) return true;
+  if ((micros() - _lastWrite) > I2C_WRITEDELAY)
+  {
+    _writePending = false;
+    return true;
+  }
+  Wire.beginTransmission(_deviceAddress);
+  if (Wire.endTransmission() != 0) return false;
+  _writePending = false;
+  return true;
+}
+
 // returns 64, 32, 16, 8, 4, 2, 1, 0
 // 0 is smaller than 1K
 int I2C_eeprom::determineSize()
@@ -197,13 +386,15 @@ int I2C_eeprom::_pageBlock(const uint16_t memoryAddress, const uint8_t* buffer,
 {
   uint16_t addr = memoryAddress;
   uint16_t len = length;
+  _startHold();
   while (len > 0)
   {
-    uint8_t bytesUntilPageBoundary = this->_pageSize - addr % this->_pageSize;
+    uint8_t bytesUntilPageBoundary = _bytesUntilPageBoundary(addr);
 
     uint8_t cnt = I2C_TWIBUFFERSIZE;
     if (cnt > len) cnt = len;
     if (cnt > bytesUntilPageBoundary) cnt = bytesUntilPageBoundary;
+    _checkHold(cnt);
 
     int rv = _WriteBlock(addr, buffer, cnt);
     if (rv != 0) return rv;
@@ -215,6 +406,55 @@ int I2C_eeprom::_pageBlock(const uint16_t memoryAddress, const uint8_t* buffer,
   return 0;
 }
 
+// _fillBlock writes value in chunks aligned to page boundaries,
+// so with a TWI buffer of at least one page every page costs one
+// write cycle. If skipSame, chunks already holding value are skipped.
+// The address is 16 bit, a range past 64 KB would wrap to address 0.
+// returns 0 = OK, -1 if the range does not fit, otherwise error
+int I2C_eeprom::_fillBlock(const uint16_t memoryAddress, const uint8_t value, const uint32_t length, const bool skipSame)
+{
+  if (memoryAddress + length > 0x10000UL) return -1;
+
+  uint8_t  buffer[I2C_TWIBUFFERSIZE];
+  uint16_t addr = memoryAddress;
+  uint32_t done = 0;
+  _startHold();
+  while (done < length)
+  {
+    uint8_t bytesUntilPageBoundary = _bytesUntilPageBoundary(addr);
+
+    uint8_t cnt = I2C_TWIBUFFERSIZE;
+    if (cnt > length - done) cnt = length - done;
+    if (cnt > bytesUntilPageBoundary) cnt = bytesUntilPageBoundary;
+    _checkHold(cnt);
+
+    bool same = false;
+    if (skipSame && (_ReadBlock(addr, buffer, cnt) == cnt))
+    {
+      same = true;
+      for (uint8_t i = 0; i < cnt; i++)
+      {
+        if (buffer[i] != value)
+        {
+          same = false;
+          break;
+        }
+      }
+    }
+    if (!same)
+    {
+      memset(buffer, value, cnt);
+      int rv = _WriteBlock(addr, buffer, cnt);
+      if (rv != 0) return rv;
+    }
+
+    addr += cnt;
+    done += cnt;
+    if (skipSame && _progress) _progress(done, length);
+  }
+  return 0;
+}
+
 // supports one and 2 bytes addresses
 void I2C_eeprom::_beginTransmission(const uint16_t memoryAddress)
 {
@@ -234,13 +474,17 @@ void I2C_eeprom::_beginTransmission(const uint16_t memoryAddress)
 // returns 0 = OK otherwise error
 int I2C_eeprom::_WriteBlock(const uint16_t memoryAddress, const uint8_t* buffer, const uint8_t length)
 {
+  _useClock();
   _waitEEReady();
 
   this->_beginTransmission(memoryAddress);
   Wire.write(buffer, length);
   int rv = Wire.endTransmission();
+  _releaseClock();
 
   _lastWrite = micros();
+  _writePending = !_isFRAM;   // FRAM has no write cycle
+  if (rv == 0 && _wear != NULL) _wear->count(memoryAddress);
   return rv;
 }
 
@@ -248,11 +492,16 @@ int I2C_eeprom::_WriteBlock(const uint16_t memoryAddress, const uint8_t* buffer,
 // returns bytes read
 uint8_t I2C_eeprom::_ReadBlock(const uint16_t memoryAddress, uint8_t* buffer, const uint8_t length)
 {
+  _useClock();
   _waitEEReady();
 
   this->_beginTransmission(memoryAddress);
   int rv = Wire.endTransmission();
-  if (rv != 0) return 0;  // error
+  if (rv != 0)
+  {
+    _releaseClock();
+    return 0;  // error
+  }
 
   // readbytes will always be equal or smaller to length
   uint8_t readBytes = Wire.requestFrom(_deviceAddress, length);
@@ -261,12 +510,69 @@ uint8_t I2C_eeprom::_ReadBlock(const uint16_t memoryAddress, uint8_t* buffer, co
   {
     buffer[cnt++] = Wire.read();
   }
+  _releaseClock();
   return readBytes;
 }
 
+void I2C_eeprom::setBusHold(const uint16_t maxBytes, const uint32_t maxMicros, void (*hook)())
+{
+  _holdBytes  = maxBytes;
+  _holdMicros = maxMicros;
+  _holdHook   = hook;
+}
+
+// a bulk transfer holds the bus from its start until it yields.
+void I2C_eeprom::_startHold()
+{
+  _heldBytes = 0;
+  _holdStart = micros();
+}
+
+// called before every chunk of a bulk transfer, yields the bus between
+// chunks once the budget is used, at least one chunk per hold.
+void I2C_eeprom::_checkHold(const uint16_t bytes)
+{
+  if (_holdBytes == 0 && _holdMicros == 0) return;
+
+  bool expired = ((_holdBytes != 0) && (_heldBytes + bytes > _holdBytes))
+              || ((_holdMicros != 0) && (micros() - _holdStart >= _holdMicros));
+  if (expired && (_heldBytes > 0))
+  {
+    if (_holdHook != NULL) _holdHook();
+    else yield();
+    _startHold();
+  }
+  _heldBytes += bytes;
+}
+
+// sets the clock of this device before a transaction. Without a
+// bus clock to restore, the bus is not shared and it is set once.
+void I2C_eeprom::_useClock()
+{
+  if (_clock == 0 || _clockApplied) return;
+  Wire.setClock(_clock);
+  _clockApplied = (_busClock == 0);
+}
+
+// restores the clock of the other devices after a transaction.
+void I2C_eeprom::_releaseClock()
+{
+  if (_clock == 0 || _busClock == 0) return;
+  Wire.setClock(_busClock);
+}
+
+// FRAM has no pages, chunks are only limited by the TWI buffer.
+uint8_t I2C_eeprom::_bytesUntilPageBoundary(const uint16_t memoryAddress)
+{
+  if (_isFRAM) return I2C_TWIBUFFERSIZE;
+  return this->_pageSize - memoryAddress % this->_pageSize;
+}
+
 void I2C_eeprom::_waitEEReady()
 {
-#define I2C_WRITEDELAY  5000
+  // Once the EEPROM has given an ACK there is no need to poll
+  // again until the next write.
+  if (!_writePending) return;
 
   // Wait until EEPROM gives ACK again.
   // this is a bit faster than the hardcoded 5 milliSeconds
@@ -274,9 +580,10 @@ void I2C_eeprom::_waitEEReady()
   {
     Wire.beginTransmission(_deviceAddress);
     int x = Wire.endTransmission();
-    if (x == 0) return;
+    if (x == 0) break;
     yield();
   }
+  _writePending = false;
   return;
 }
 
@@ -2,7 +2,7 @@
 //
 //    FILE: I2C_eeprom.h
 //  AUTHOR: Rob Tillaart
-// VERSION: 1.3.1
+// VERSION: 1.4.0
 // PURPOSE: Arduino Library for external I2C EEPROM 24LC256 et al.
 //     URL: https://github.com/RobTillaart/I2C_EEPROM.git
 //
@@ -12,7 +12,7 @@
 #include "Arduino.h"
 #include "Wire.h"
 
-#define I2C_EEPROM_VERSION "1.3.1"
+#define I2C_EEPROM_VERSION "1.4.0"
 
 // The DEFAULT page size. This is overriden if you use the second constructor.
 // I2C_EEPROM_PAGESIZE must be multiple of 2 e.g. 16, 32 or 64
@@ -21,13 +21,46 @@
 
 // TWI buffer needs max 2 bytes for eeprom address
 // 1 byte for eeprom register address is available in txbuffer
+// Platforms with a larger Wire buffer can write a full page per transaction.
+#ifndef I2C_TWIBUFFERSIZE
+#if defined(ESP32) || defined(ESP8266)
+#define I2C_TWIBUFFERSIZE  126
+#elif defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_RP2040)
+#define I2C_TWIBUFFERSIZE  254
+#else
 #define I2C_TWIBUFFERSIZE  30
+#endif
+#endif
+
+// bus clocks for setClock() and probeClock()
+#define I2C_EEPROM_CLOCK_100K   100000UL
+#define I2C_EEPROM_CLOCK_400K   400000UL
+#define I2C_EEPROM_CLOCK_1M    1000000UL
+
+// bytes compared by probeClock()
+#ifndef I2C_EEPROM_PROBE_SIZE
+#define I2C_EEPROM_PROBE_SIZE   16
+#endif
+
+// common device sizes in bytes, for the second constructor
+#define I2C_DEVICESIZE_24LC512  65536
+#define I2C_DEVICESIZE_24LC256  32768
+#define I2C_DEVICESIZE_24LC128  16384
+#define I2C_DEVICESIZE_24LC64    8192
+#define I2C_DEVICESIZE_24LC32    4096
+#define I2C_DEVICESIZE_24LC16    2048
+#define I2C_DEVICESIZE_24LC08    1024
+#define I2C_DEVICESIZE_24LC04     512
+#define I2C_DEVICESIZE_24LC02     256
+#define I2C_DEVICESIZE_24LC01     128
+
+class I2C_eeprom_wear;
 
 class I2C_eeprom
 {
 public:
   /**
-    * Initializes the EEPROM with a default pagesize of I2C_EEPROM_PAGESIZE.
+    * Initializes the EEPROM as a 24LC256, i.e. a pagesize of I2C_EEPROM_PAGESIZE.
     */
   I2C_eeprom(const uint8_t deviceAddress);
 
@@ -39,7 +72,7 @@ public:
     * @param deviceAddress Byte address of the device.
     * @param deviceSize    Max size in bytes of the device (divide your device size in Kbits by 8)
     */
-  I2C_eeprom(const uint8_t deviceAddress, const unsigned int deviceSize);
+  I2C_eeprom(const uint8_t deviceAddress, const uint32_t deviceSize);
 
 #if defined (ESP8266) || defined(ESP32)
   void begin(uint8_t sda, uint8_t scl);
@@ -61,13 +94,86 @@ public:
   // updates a byte at memory address, writes only if there is a new value.
   // return 0 if data is same or written OK, error code otherwise.
   int      updateByte(const uint16_t memoryAddress, const uint8_t value);
+  // updates a block in memory, writes only the page chunks that changed.
+  // return 0 if data is same or written OK, error code otherwise.
+  int      updateBlock(const uint16_t memoryAddress, const uint8_t* buffer, const uint16_t length);
+
+  // fills length bytes with value like setBlock() but page chunks
+  // that already hold value are skipped, costing a read instead of
+  // a write cycle. Progress is reported through the callback if set.
+  // return 0 if OK, -1 if the range passes 64 KB, error code otherwise.
+  int      erase(const uint16_t memoryAddress, const uint32_t length, const uint8_t value = 0xFF);
+  // erases the whole device
+  int      erase(const uint8_t value = 0xFF) { return erase(0, _deviceSize, value); };
+  // callback(done, total) is called after every page chunk of erase()
+  void     setProgressCallback(void (*callback)(uint32_t done, uint32_t total)) { _progress = callback; };
+
+  // copies length bytes within this device, overlapping ranges are
+  // handled like memmove(). Uses one buffer of I2C_TWIBUFFERSIZE bytes.
+  // return 0 if OK, -1 if a read failed, error code otherwise.
+  int      copyBlock(const uint16_t source, const uint16_t destination, const uint16_t length);
+  // copies length bytes to another device. The next chunk is read
+  // from this device while target is busy with its write cycle.
+  int      copyBlock(const uint16_t source, I2C_eeprom &target, const uint16_t destination, const uint16_t length);
+
+  // counts every write transaction in wear, NULL = off (default).
+  // normally called by I2C_eeprom_wear::begin().
+  void     setWearMap(I2C_eeprom_wear *wear) { _wear = wear; };
+  I2C_eeprom_wear * getWearMap() { return _wear; };
+
+  // FRAM mode for FRAM with the 24LC protocol, e.g. MB85RC256.
+  // FRAM has no write cycle and no pages, so there is no ACK polling
+  // and writes are only split at I2C_TWIBUFFERSIZE. Default false.
+  void     setFRAM(const bool fram) { _isFRAM = fram; if (fram) _writePending = false; };
+  bool     isFRAM() { return _isFRAM; };
+
+  // bus clock for this device, 0 = leave the clock alone (default).
+  // if busClock != 0 the bus is shared with slower devices, the clock is
+  // set before and busClock is restored after every transaction.
+  void     setClock(const uint32_t clock, const uint32_t busClock = 0);
+  uint32_t getClock()    { return _clock; };
+  uint32_t getBusClock() { return _busClock; };
+  // finds the highest clock up to maxClock at which a read of
+  // I2C_EEPROM_PROBE_SIZE bytes at memoryAddress returns the same data
+  // as at 100 KHz and uses it as with setClock(clock, getBusClock()).
+  // If these bytes are all the same, e.g. erased, it gives 100 KHz.
+  // With scratch a pattern is written at memoryAddress and probed,
+  // only use this on bytes that may be lost.
+  // returns the clock, 0 if the device can not be read,
+  // the clock is then not changed.
+  uint32_t probeClock(const uint16_t memoryAddress = 0, const uint32_t maxClock = I2C_EEPROM_CLOCK_1M, const bool scratch = false);
+
+  // limits how long a bulk transfer holds the bus, e.g. for a sensor on
+  // the same bus. Once maxBytes bytes are transferred or maxMicros passed,
+  // hook is called before the next page chunk, default yield().
+  // 0 = no limit, both 0 = never yield (default).
+  void     setBusHold(const uint16_t maxBytes, const uint32_t maxMicros = 0, void (*hook)() = NULL);
+
+  // true if the device can take the next transaction, i.e. no write
+  // cycle is pending. Polls the device at most once, does not wait.
+  bool     isReady();
 
   int      determineSize();
+  uint8_t  getPageSize()   { return _pageSize; };
+  uint32_t getDeviceSize() { return _deviceSize; };
 
 private:
   uint8_t  _deviceAddress;
   uint32_t _lastWrite;     // for waitEEReady
+  bool     _writePending;  // for waitEEReady, no need to poll if false
   uint8_t  _pageSize;
+  uint32_t _deviceSize;
+  void     (*_progress)(uint32_t done, uint32_t total);
+  I2C_eeprom_wear * _wear;
+  bool     _isFRAM;
+  uint32_t _clock;
+  uint32_t _busClock;
+  bool     _clockApplied;  // _clock set and not restored since
+  uint16_t _holdBytes;
+  uint32_t _holdMicros;
+  void     (*_holdHook)();
+  uint16_t _heldBytes;
+  uint32_t _holdStart;
 
   // for some smaller chips that use one-word addresses
   bool     _isAddressSizeTwoWords;
@@ -79,11 +185,17 @@ private:
     */
   void     _beginTransmission(const uint16_t memoryAddress);
 
+  uint8_t  _bytesUntilPageBoundary(const uint16_t memoryAddress);
   int      _pageBlock(const uint16_t memoryAddress, const uint8_t* buffer, const uint16_t length, const bool incrBuffer);
+  int      _fillBlock(const uint16_t memoryAddress, const uint8_t value, const uint32_t length, const bool skipSame);
   int      _WriteBlock(const uint16_t memoryAddress, const uint8_t* buffer, const uint8_t length);
   uint8_t  _ReadBlock(const uint16_t memoryAddress, uint8_t* buffer, const uint8_t length);
 
   void     _waitEEReady();
+  void     _startHold();
+  void     _checkHold(const uint16_t bytes);
+  void     _useClock();
+  void     _releaseClock();
 };
 
 // -- END OF FILE --
@@ -0,0 +1,309 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_async.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: C++20 coroutine interface for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// only with a C++20 compiler, e.g. ESP-IDF, RP2040 or a host,
+// I2C_EEPROM_COROUTINES is defined if available.
+#if __cplusplus >= 202002L
+#if __has_include(<coroutine>)
+
+#include <coroutine>
+
+#define I2C_EEPROM_COROUTINES
+
+// maximum number of operations running at the same time
+#ifndef I2C_EEPROM_EXECUTOR_TASKS
+#define I2C_EEPROM_EXECUTOR_TASKS  8
+#endif
+
+/**
+ * @brief An EEPROM operation or any other coroutine run by the
+ * I2C_eeprom_executor, with an int result.
+ *
+ * An operation starts when it is awaited with co_await, which returns
+ * its result, or when it is passed to I2C_eeprom_executor::spawn().
+ * The frame is allocated with new, like every coroutine.
+ */
+class I2C_eeprom_op
+{
+public:
+    struct promise_type
+    {
+        int result = 0;
+        std::coroutine_handle<> continuation;
+
+        I2C_eeprom_op get_return_object()
+        {
+            return I2C_eeprom_op(std::coroutine_handle<promise_type>::from_promise(*this));
+        };
+        std::suspend_always initial_suspend() noexcept { return {}; };
+        auto final_suspend() noexcept
+        {
+            // resumes the awaiting coroutine, if any
+            struct awaiter
+            {
+                bool await_ready() noexcept { return false; };
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                {
+                    auto continuation = h.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                };
+                void await_resume() noexcept {};
+            };
+            return awaiter{};
+        };
+        void return_value(int value) { result = value; };
+        void unhandled_exception() {};
+    };
+
+    I2C_eeprom_op(I2C_eeprom_op &&other) : _handle(other._handle) { other._handle = nullptr; };
+    I2C_eeprom_op(const I2C_eeprom_op &) = delete;
+    ~I2C_eeprom_op() { if (_handle) _handle.destroy(); };
+
+    bool done() { return !_handle || _handle.done(); };
+    int  result() { return _handle ? _handle.promise().result : 0; };
+
+    // co_await runs the operation and returns its result.
+    bool await_ready() { return done(); };
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+    {
+        _handle.promise().continuation = awaiting;
+        return _handle;
+    };
+    int  await_resume() { return result(); };
+
+private:
+    friend class I2C_eeprom_executor;
+    explicit I2C_eeprom_op(std::coroutine_handle<promise_type> handle) : _handle(handle) {};
+    std::coroutine_handle<promise_type> _handle;
+};
+
+
+/**
+ * @brief Single threaded executor that resumes the waiting coroutines
+ * in turn.
+ *
+ * A coroutine waits with co_await yield(), e.g. during the write cycle
+ * of the eeprom, so one loop() can interleave several EEPROM and sensor
+ * operations without blocking on any of them.
+ */
+class I2C_eeprom_executor
+{
+public:
+    /**
+      * @brief Starts an operation, the executor owns it from now on.
+      *
+      * @param op     The operation to start.
+      * @param result Set to the result of op when it is done, may be NULL.
+      * @return False if I2C_EEPROM_EXECUTOR_TASKS operations are running.
+      */
+    bool spawn(I2C_eeprom_op &&op, int *result = NULL)
+    {
+        for (uint8_t i = 0; i < I2C_EEPROM_EXECUTOR_TASKS; i++)
+        {
+            if (_tasks[i].handle) continue;
+            _tasks[i].handle = op._handle;
+            _tasks[i].result = result;
+            op._handle = nullptr;
+            _schedule(_tasks[i].handle);
+            _running++;
+            return true;
+        }
+        return false;
+    };
+
+    /**
+      * @brief Resumes every waiting coroutine once, call it from loop().
+      *
+      * @return True while operations are running.
+      */
+    bool poll()
+    {
+        for (uint8_t n = _count; n > 0; n--)
+        {
+            std::coroutine_handle<> handle = _queue[_head];
+            _head = (_head + 1) % I2C_EEPROM_EXECUTOR_TASKS;
+            _count--;
+            handle.resume();
+        }
+        for (uint8_t i = 0; i < I2C_EEPROM_EXECUTOR_TASKS; i++)
+        {
+            if (!_tasks[i].handle || !_tasks[i].handle.done()) continue;
+            if (_tasks[i].result != NULL) *_tasks[i].result = _tasks[i].handle.promise().result;
+            _tasks[i].handle.destroy();
+            _tasks[i].handle = nullptr;
+            _running--;
+        }
+        return _running > 0;
+    };
+
+    // polls until all operations are done.
+    void run() { while (poll()) {}; };
+
+    // number of operations running.
+    uint8_t count() { return _running; };
+
+    /**
+      * @brief Awaitable that suspends the coroutine until the next poll().
+      */
+    auto yield()
+    {
+        struct awaiter
+        {
+            I2C_eeprom_executor * executor;
+            bool await_ready() { return false; };
+            void await_suspend(std::coroutine_handle<> h) { executor->_schedule(h); };
+            void await_resume() {};
+        };
+        return awaiter{ this };
+    };
+
+    /**
+      * @brief Operation that waits ms milliseconds without blocking.
+      */
+    I2C_eeprom_op sleep(const uint32_t ms)
+    {
+        uint32_t start = millis();
+        while (millis() - start < ms) co_await yield();
+        co_return 0;
+    };
+
+private:
+    struct task
+    {
+        std::coroutine_handle<I2C_eeprom_op::promise_type> handle;
+        int * result;
+    };
+
+    // every operation waits at one point at most, so the queue
+    // can not hold more handles than there are operations.
+    std::coroutine_handle<> _queue[I2C_EEPROM_EXECUTOR_TASKS];
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+    task    _tasks[I2C_EEPROM_EXECUTOR_TASKS] = {};
+    uint8_t _running = 0;
+
+    void _schedule(std::coroutine_handle<> h)
+    {
+        _queue[(_head + _count) % I2C_EEPROM_EXECUTOR_TASKS] = h;
+        _count++;
+    };
+};
+
+
+/**
+ * @brief Coroutine versions of the block operations of I2C_eeprom.
+ *
+ * The transfers are split in the same page and TWI buffer chunks as
+ * I2C_eeprom does, but instead of polling the device in a loop during
+ * the write cycle the operation yields to the executor until isReady().
+ * The buffers must stay valid until the operation is done.
+ *
+ * @tparam EEPROM the eeprom class, only to be replaced by a fake with the
+ * same interface for testing.
+ */
+template <typename EEPROM = I2C_eeprom>
+class I2C_eeprom_async
+{
+public:
+    /**
+      * @param eeprom   The instance of I2C_eeprom to use.
+      * @param executor The executor that runs the operations.
+      */
+    I2C_eeprom_async(EEPROM &eeprom, I2C_eeprom_executor &executor)
+        : _eeprom(&eeprom), _executor(&executor)
+    {
+    };
+
+    /**
+      * @return 0 if OK, error code of I2C_eeprom otherwise.
+      */
+    I2C_eeprom_op writeBlock(uint16_t memoryAddress, const uint8_t *buffer, uint16_t length)
+    {
+        while (length > 0)
+        {
+            uint8_t cnt = _chunk(memoryAddress, length);
+            while (!_eeprom->isReady()) co_await _executor->yield();
+            int rv = _eeprom->writeBlock(memoryAddress, buffer, cnt);
+            if (rv != 0) co_return rv;
+            memoryAddress += cnt;
+            buffer += cnt;
+            length -= cnt;
+        }
+        co_return 0;
+    };
+
+    /**
+      * @return Number of bytes read.
+      */
+    I2C_eeprom_op readBlock(uint16_t memoryAddress, uint8_t *buffer, uint16_t length)
+    {
+        int rv = 0;
+        while (length > 0)
+        {
+            uint8_t cnt = _chunk(memoryAddress, length);
+            while (!_eeprom->isReady()) co_await _executor->yield();
+            uint16_t n = _eeprom->readBlock(memoryAddress, buffer, cnt);
+            rv += n;
+            if (n != cnt) break;
+            memoryAddress += cnt;
+            buffer += cnt;
+            length -= cnt;
+            // let other operations use the bus between chunks
+            if (length > 0) co_await _executor->yield();
+        }
+        co_return rv;
+    };
+
+    /**
+      * @brief Writes only the chunks that changed.
+      * @return 0 if OK, error code of I2C_eeprom otherwise.
+      */
+    I2C_eeprom_op updateBlock(uint16_t memoryAddress, const uint8_t *buffer, uint16_t length)
+    {
+        uint8_t current[I2C_TWIBUFFERSIZE];
+        while (length > 0)
+        {
+            uint8_t cnt = _chunk(memoryAddress, length);
+            while (!_eeprom->isReady()) co_await _executor->yield();
+            if ((_eeprom->readBlock(memoryAddress, current, cnt) != cnt)
+               || (memcmp(current, buffer, cnt) != 0))
+            {
+                int rv = _eeprom->writeBlock(memoryAddress, buffer, cnt);
+                if (rv != 0) co_return rv;
+            }
+            memoryAddress += cnt;
+            buffer += cnt;
+            length -= cnt;
+        }
+        co_return 0;
+    };
+
+private:
+    EEPROM * _eeprom;
+    I2C_eeprom_executor * _executor;
+
+    // bytes of one transaction: up to the page boundary and the TWI buffer.
+    uint8_t _chunk(const uint16_t memoryAddress, const uint16_t length)
+    {
+        uint16_t cnt = I2C_TWIBUFFERSIZE;
+        if (!_eeprom->isFRAM())
+        {
+            uint8_t room = _eeprom->getPageSize() - memoryAddress % _eeprom->getPageSize();
+            if (room < cnt) cnt = room;
+        }
+        if (length < cnt) cnt = length;
+        return cnt;
+    };
+};
+
+#endif
+#endif
+
+// -- END OF FILE --
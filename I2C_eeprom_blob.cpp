@@ -0,0 +1,163 @@
+//
+//    FILE: I2C_eeprom_blob.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Compressed int16 tables on top of I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// header { count, size }
+// data   varint(zigzag(value[i] - value[i - 1])) * count, value[-1] = 0
+//
+// begin() invalidates the header before the data is overwritten and
+// end() writes it after the data, so a reset in between leaves no table
+// instead of a header that does not match the data.
+
+
+#include <I2C_eeprom_blob.h>
+
+
+////////////////////////////////////////////////////////////////////
+//
+// WRITER
+//
+
+I2C_eeprom_blob_writer::I2C_eeprom_blob_writer(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length)
+  : _writer(eeprom, memoryAddress + I2C_EEPROM_BLOB_HEADER,
+            length > I2C_EEPROM_BLOB_HEADER ? length - I2C_EEPROM_BLOB_HEADER : 0)
+{
+  _eeprom   = &eeprom;
+  _start    = memoryAddress;
+  _length   = length;
+  _count    = 0;
+  _previous = 0;
+  _full     = length <= I2C_EEPROM_BLOB_HEADER;
+}
+
+bool I2C_eeprom_blob_writer::begin()
+{
+  if (_length <= I2C_EEPROM_BLOB_HEADER) return false;
+
+  uint16_t none = I2C_EEPROM_BLOB_NONE;
+  if (_eeprom->writeBlock(_start, (uint8_t *)&none, sizeof(none)) != 0) return false;
+
+  _writer   = I2C_eeprom_writer(*_eeprom, _start + I2C_EEPROM_BLOB_HEADER, _length - I2C_EEPROM_BLOB_HEADER);
+  _count    = 0;
+  _previous = 0;
+  _full     = false;
+  return true;
+}
+
+size_t I2C_eeprom_blob_writer::write(const int16_t value)
+{
+  if (_full || _count == I2C_EEPROM_BLOB_NONE - 1) return 0;
+
+  uint16_t delta = (uint16_t)value - (uint16_t)_previous;
+  uint16_t zigzag = (delta << 1) ^ (uint16_t)((int16_t)delta >> 15);
+
+  uint8_t buffer[3];
+  uint8_t n = 0;
+  while (zigzag >= 0x80)
+  {
+    buffer[n++] = (zigzag & 0x7F) | 0x80;
+    zigzag >>= 7;
+  }
+  buffer[n++] = zigzag;
+
+  // a value is stored completely or not at all
+  if ((_writer.availableForWrite() < n) || (_writer.write(buffer, n) != n))
+  {
+    _full = true;
+    return 0;
+  }
+  _previous = value;
+  _count++;
+  return 1;
+}
+
+size_t I2C_eeprom_blob_writer::write(const int16_t *values, const uint16_t count)
+{
+  size_t cnt = 0;
+  while (cnt < count && write(values[cnt]) == 1) cnt++;
+  return cnt;
+}
+
+int I2C_eeprom_blob_writer::end()
+{
+  _writer.flush();
+  if (_writer.lastError() != 0) return _writer.lastError();
+
+  uint16_t header[2] = { _count, size() };
+  int rv = _eeprom->writeBlock(_start, (uint8_t *)header, I2C_EEPROM_BLOB_HEADER);
+  if (rv != 0) return rv;
+  return _full ? -1 : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// READER
+//
+
+I2C_eeprom_blob_reader::I2C_eeprom_blob_reader(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length)
+  : _reader(eeprom, memoryAddress, length)
+{
+  _start    = memoryAddress;
+  _length   = length;
+  _count    = 0;
+  _size     = 0;
+  _index    = 0;
+  _previous = 0;
+}
+
+bool I2C_eeprom_blob_reader::begin()
+{
+  _count    = 0;
+  _size     = 0;
+  _index    = 0;
+  _previous = 0;
+  if (_length <= I2C_EEPROM_BLOB_HEADER) return false;
+
+  uint16_t header[2];
+  if (!_reader.seek(_start)) return false;
+  if (_reader.read((uint8_t *)header, I2C_EEPROM_BLOB_HEADER) != I2C_EEPROM_BLOB_HEADER) return false;
+  if (header[0] == I2C_EEPROM_BLOB_NONE) return false;
+  if (header[1] > _length - I2C_EEPROM_BLOB_HEADER) return false;
+
+  _count = header[0];
+  _size  = header[1];
+  return true;
+}
+
+bool I2C_eeprom_blob_reader::read(int16_t &value)
+{
+  if (_index >= _count) return false;
+
+  uint16_t zigzag = 0;
+  uint8_t  shift  = 0;
+  while (true)
+  {
+    int b = _reader.read();
+    if (b < 0 || shift > 14) return false;
+    zigzag |= (uint16_t)(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) break;
+    shift += 7;
+  }
+  uint16_t delta = (zigzag >> 1) ^ (uint16_t)(0 - (zigzag & 1));
+
+  _previous = (int16_t)((uint16_t)_previous + delta);
+  _index++;
+  value = _previous;
+  return true;
+}
+
+uint16_t I2C_eeprom_blob_reader::read(int16_t *values, const uint16_t count)
+{
+  uint16_t cnt = 0;
+  while (cnt < count && read(values[cnt])) cnt++;
+  return cnt;
+}
+
+// -- END OF FILE --
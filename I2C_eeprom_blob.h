@@ -0,0 +1,95 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_blob.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Compressed int16 tables on top of I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+#include <I2C_eeprom_reader.h>
+#include <I2C_eeprom_writer.h>
+
+// bytes before the data for { count, size }
+#define I2C_EEPROM_BLOB_HEADER  4
+
+// no blob stored
+#define I2C_EEPROM_BLOB_NONE    0xFFFF
+
+// Values are stored as the difference with the previous value, zigzag
+// encoded so small negative differences are small too, as a varint of
+// 7 bits per byte. Slowly varying tables take 1 byte per value.
+
+class I2C_eeprom_blob_writer
+{
+public:
+  /**
+    * Writes a compressed table of int16_t values to a region.
+    *
+    * @param eeprom        The instance of I2C_eeprom to write to.
+    * @param memoryAddress Address of the first byte of the region.
+    * @param length        Number of bytes in the region.
+    */
+  I2C_eeprom_blob_writer(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length);
+
+  // invalidates the stored table and starts a new one.
+  bool     begin();
+  // appends values, returns the number of values stored.
+  size_t   write(const int16_t value);
+  size_t   write(const int16_t *values, const uint16_t count);
+  // writes the remaining data and then the header.
+  // return 0 if OK, -1 if not all values fitted, error code otherwise.
+  int      end();
+
+  uint16_t count() { return _count; };
+  // compressed size in bytes, without the header.
+  uint16_t size()  { return _writer.position() - _start - I2C_EEPROM_BLOB_HEADER; };
+
+private:
+  I2C_eeprom * _eeprom;
+  I2C_eeprom_writer _writer;
+  uint16_t _start;
+  uint16_t _length;
+  uint16_t _count;
+  int16_t  _previous;
+  bool     _full;
+};
+
+
+class I2C_eeprom_blob_reader
+{
+public:
+  /**
+    * Reads a table written by I2C_eeprom_blob_writer while it is
+    * decompressed, so only the values asked for need RAM. The data is
+    * fetched with the read-ahead window of I2C_eeprom_reader.
+    *
+    * @param eeprom        The instance of I2C_eeprom to read from.
+    * @param memoryAddress Address of the first byte of the region.
+    * @param length        Number of bytes in the region.
+    */
+  I2C_eeprom_blob_reader(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length);
+
+  // reads the header and starts at the first value.
+  // returns false if no table is stored.
+  bool     begin();
+  // values not read yet.
+  uint16_t available() { return _count - _index; };
+  bool     read(int16_t &value);
+  // returns the number of values read.
+  uint16_t read(int16_t *values, const uint16_t count);
+
+  uint16_t count() { return _count; };
+  uint16_t size()  { return _size; };
+
+private:
+  I2C_eeprom_reader _reader;
+  uint16_t _start;
+  uint16_t _length;
+  uint16_t _count;
+  uint16_t _size;
+  uint16_t _index;
+  int16_t  _previous;
+};
+
+// -- END OF FILE --
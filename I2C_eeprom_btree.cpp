@@ -0,0 +1,511 @@
+//
+//    FILE: I2C_eeprom_btree.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: B+tree index with one page per node for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// first page  { magic, root, nextFree, height, valueSize, split, crc8 }
+// leaf        { 1, count, next leaf } { key, value } * count
+// inner       { 0, count, child 0 } { key, child } * count
+//
+// A node is at most I2C_TWIBUFFERSIZE bytes of its page, so it is
+// written in one transaction and one write cycle, never torn between
+// two chunks of a page, e.g. on AVR a 64 byte page holds a 30 byte node.
+// The key of entry i of an inner node is the lowest key of child i + 1.
+// Pages are never freed, nextFree is written before a new page is used.
+// A split writes the new node, the node split and then its parent. The
+// split flag is set in the first page until the split is done, begin()
+// completes a split interrupted by a reset, see _repair().
+
+
+#include <I2C_eeprom_btree.h>
+
+#define I2C_EEPROM_BTREE_MAGIC  0x54424545UL   // "EEBT"
+#define I2C_EEPROM_BTREE_INNER  (sizeof(uint32_t) + sizeof(uint16_t))
+
+
+bool I2C_eeprom_btree::begin(I2C_eeprom &eeprom, uint8_t *cache, const uint8_t cachePages,
+                             const uint16_t firstPage, const uint16_t pages, const uint8_t valueSize)
+{
+  _eeprom     = NULL;
+  _pageSize   = eeprom.getPageSize();
+  _nodeSize   = (_pageSize < I2C_TWIBUFFERSIZE) ? _pageSize : I2C_TWIBUFFERSIZE;
+  if (_nodeSize <= I2C_EEPROM_BTREE_HEADER) return false;
+  _leafSlots  = (_nodeSize - I2C_EEPROM_BTREE_HEADER) / (sizeof(uint32_t) + valueSize);
+  _innerSlots = (_nodeSize - I2C_EEPROM_BTREE_HEADER) / I2C_EEPROM_BTREE_INNER;
+  if ((_leafSlots < 2) || (_innerSlots < 3) || (pages < 2)) return false;
+  if ((cachePages > I2C_EEPROM_BTREE_CACHE) || ((cachePages > 0) && (cache == NULL))) return false;
+
+  _eeprom      = &eeprom;
+  _cache       = cache;
+  _cachePages  = cachePages;
+  _tick        = 0;
+  _firstPage   = firstPage;
+  _pages       = pages;
+  _valueSize   = valueSize;
+  _root        = firstPage + 1;
+  _nextFree    = firstPage + 2;
+  _height      = 1;
+  _split       = false;
+  _hits        = 0;
+  _reads       = 0;
+  _cursorPage  = I2C_EEPROM_BTREE_NONE;
+  for (uint8_t i = 0; i < I2C_EEPROM_BTREE_CACHE; i++) _cached[i] = I2C_EEPROM_BTREE_NONE;
+
+  meta m;
+  if (_eeprom->readBlock(_firstPage * _pageSize, (uint8_t *)&m, sizeof(m)) != sizeof(m)) return false;
+  if (m.magic != I2C_EEPROM_BTREE_MAGIC) return false;
+  if (m.crc != _crc8(0, (uint8_t *)&m, (uint8_t *)&m.crc - (uint8_t *)&m)) return false;
+  if (m.valueSize != _valueSize) return false;
+  if ((m.height == 0) || (m.height > I2C_EEPROM_BTREE_DEPTH)) return false;
+  if ((m.nextFree > _firstPage + _pages) || (m.root <= _firstPage) || (m.root >= m.nextFree)) return false;
+
+  _root     = m.root;
+  _nextFree = m.nextFree;
+  _height   = m.height;
+  _split    = (m.split != 0);
+  return !_split || (_repair() == 0);
+}
+
+bool I2C_eeprom_btree::format()
+{
+  if (_eeprom == NULL) return false;
+
+  for (uint8_t i = 0; i < I2C_EEPROM_BTREE_CACHE; i++) _cached[i] = I2C_EEPROM_BTREE_NONE;
+  _root       = _firstPage + 1;
+  _nextFree   = _firstPage + 2;
+  _height     = 1;
+  _split      = false;
+  _cursorPage = I2C_EEPROM_BTREE_NONE;
+
+  // empty root leaf first, then the first page that refers to it
+  uint8_t node[_pageSize];
+  node[0] = 1;
+  node[1] = 0;
+  node[2] = node[3] = 0xFF;
+  if (_writeNode(_root, node) != 0) return false;
+  return _writeMeta() == 0;
+}
+
+int I2C_eeprom_btree::insert(const uint32_t key, const void *value)
+{
+  if (_eeprom == NULL) return -1;
+  // a split that failed half way is completed first
+  if (_split)
+  {
+    int rv = _repair();
+    if (rv != 0) return rv;
+  }
+
+  uint8_t  node[_pageSize];
+  uint16_t path[I2C_EEPROM_BTREE_DEPTH];
+  bool     rightmost;
+  if (!_descend(key, node, path, &rightmost)) return -1;
+
+  uint8_t  es  = _entrySize(node);
+  uint8_t  pos = _lowerBound(node, key);
+  if ((pos < node[1]) && (_key(node, pos) == key))
+  {
+    // replace the value only if it changed
+    uint8_t * current = node + I2C_EEPROM_BTREE_HEADER + pos * es + sizeof(uint32_t);
+    if (memcmp(current, value, _valueSize) == 0) return 0;
+    memcpy(current, value, _valueSize);
+    return _writeNode(path[_height - 1], node);
+  }
+  // a full leaf can split up to the root, check all pages are there
+  // before anything is written, also the ones a repair could need.
+  if ((node[1] == _leafSlots) && ((getFreePages() < 2 * _height + 1) || (_height == I2C_EEPROM_BTREE_DEPTH))) return -1;
+
+  uint8_t  entry[sizeof(uint32_t) + _valueSize + sizeof(uint16_t)];
+  memcpy(entry, &key, sizeof(uint32_t));
+  memcpy(entry + sizeof(uint32_t), value, _valueSize);
+  return _insertEntry(_height - 1, path, node, pos, entry, rightmost, true);
+}
+
+bool I2C_eeprom_btree::find(const uint32_t key, void *value)
+{
+  if (_eeprom == NULL) return false;
+
+  uint8_t  node[_pageSize];
+  uint16_t path[I2C_EEPROM_BTREE_DEPTH];
+  bool     rightmost;
+  if (!_descend(key, node, path, &rightmost)) return false;
+
+  uint8_t pos = _lowerBound(node, key);
+  if ((pos >= node[1]) || (_key(node, pos) != key)) return false;
+  memcpy(value, node + I2C_EEPROM_BTREE_HEADER + pos * _entrySize(node) + sizeof(uint32_t), _valueSize);
+  return true;
+}
+
+bool I2C_eeprom_btree::seek(const uint32_t from, const uint32_t to)
+{
+  _cursorPage = I2C_EEPROM_BTREE_NONE;
+  if (_eeprom == NULL) return false;
+
+  uint8_t  node[_pageSize];
+  uint16_t path[I2C_EEPROM_BTREE_DEPTH];
+  bool     rightmost;
+  if (!_descend(from, node, path, &rightmost)) return false;
+
+  // the leaf is in node, no need to read its header again
+  _cursorPage   = path[_height - 1];
+  _cursorIndex  = _lowerBound(node, from);
+  _cursorTo     = to;
+  _cursorCount  = node[1];
+  _cursorNext   = _child(node, 0);
+  _cursorLoaded = true;
+  return true;
+}
+
+// A cached leaf is read from the eeprom only once. Without a cache the
+// header of a leaf is read once and then only the record of every call,
+// as the time series does, instead of the whole leaf per record.
+bool I2C_eeprom_btree::next(uint32_t &key, void *value)
+{
+  uint8_t  es = sizeof(uint32_t) + _valueSize;
+  uint8_t  record[es];
+  while (_cursorPage != I2C_EEPROM_BTREE_NONE)
+  {
+    if (!_cursorLoaded)
+    {
+      uint8_t node[_pageSize];
+      if (_cachePages > 0)
+      {
+        if (!_readNode(_cursorPage, node) || (node[0] != 1)) break;
+      }
+      else
+      {
+        if (_eeprom->readBlock(_cursorPage * _pageSize, node, I2C_EEPROM_BTREE_HEADER) != I2C_EEPROM_BTREE_HEADER) break;
+        _reads++;
+        if ((node[0] != 1) || (node[1] > _leafSlots)) break;
+      }
+      _cursorCount  = node[1];
+      _cursorNext   = _child(node, 0);
+      _cursorLoaded = true;
+    }
+    if (_cursorIndex < _cursorCount)
+    {
+      uint16_t offset = I2C_EEPROM_BTREE_HEADER + _cursorIndex * es;
+      int8_t   idx    = _cacheFind(_cursorPage);
+      if (idx >= 0) memcpy(record, _cache + idx * _pageSize + offset, es);
+      else if (_eeprom->readBlock(_cursorPage * _pageSize + offset, record, es) != es) break;
+      uint32_t k;
+      memcpy(&k, record, sizeof(k));
+      if (k > _cursorTo) break;
+      key = k;
+      memcpy(value, record + sizeof(uint32_t), _valueSize);
+      _cursorIndex++;
+      return true;
+    }
+    _cursorPage   = _cursorNext;
+    _cursorIndex  = 0;
+    _cursorLoaded = false;
+  }
+  _cursorPage = I2C_EEPROM_BTREE_NONE;
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// inserts entry at pos of node, the node at path[level], and splits
+// up to the root if needed. If last, the split flag is cleared at the end.
+int I2C_eeprom_btree::_insertEntry(uint8_t level, uint16_t *path, uint8_t *node, uint8_t pos,
+                                   uint8_t *entry, const bool rightmost, const bool last)
+{
+  uint8_t  right[_pageSize];
+  while (true)
+  {
+    uint8_t  count = node[1];
+    uint8_t  slots = node[0] ? _leafSlots : _innerSlots;
+    uint8_t  n     = count + 1;
+    uint8_t  es    = _entrySize(node);
+
+    // all entries of the node with the new one in its place
+    uint8_t  all[_pageSize + es];
+    uint8_t  * entries = node + I2C_EEPROM_BTREE_HEADER;
+    memcpy(all, entries, pos * es);
+    memcpy(all + pos * es, entry, es);
+    memcpy(all + (pos + 1) * es, entries + pos * es, (count - pos) * es);
+
+    if (n <= slots)
+    {
+      memcpy(entries, all, n * es);
+      node[1] = n;
+      int rv = _writeNode(path[level], node);
+      if ((rv != 0) || !_split || !last) return rv;
+      _split = false;
+      return _writeMeta();
+    }
+
+    // split, appending keys keep the left node full
+    _split = true;
+    uint16_t newPage = _nextFree++;
+    int rv = _writeMeta();
+    if (rv != 0) return rv;
+
+    uint8_t  mid = (rightmost && (pos == count)) ? count : n / 2;
+    uint32_t separator;
+    memcpy(&separator, all + mid * es, sizeof(uint32_t));
+    right[0] = node[0];
+    if (node[0])
+    {
+      // leaf, the right node gets the records from mid on
+      right[1] = n - mid;
+      memcpy(right + 2, node + 2, sizeof(uint16_t));
+      memcpy(node + 2, &newPage, sizeof(uint16_t));
+      memcpy(right + I2C_EEPROM_BTREE_HEADER, all + mid * es, (n - mid) * es);
+    }
+    else
+    {
+      // inner, the key at mid moves up, its child becomes child 0
+      right[1] = n - mid - 1;
+      memcpy(right + 2, all + mid * es + sizeof(uint32_t), sizeof(uint16_t));
+      memcpy(right + I2C_EEPROM_BTREE_HEADER, all + (mid + 1) * es, (n - mid - 1) * es);
+    }
+    memcpy(entries, all, mid * es);
+    node[1] = mid;
+
+    rv = _writeNode(newPage, right);
+    if (rv != 0) return rv;
+    rv = _writeNode(path[level], node);
+    if (rv != 0) return rv;
+
+    memcpy(entry, &separator, sizeof(uint32_t));
+    memcpy(entry + sizeof(uint32_t), &newPage, sizeof(uint16_t));
+    if (level == 0) return _newRoot(entry, last);
+    level--;
+    if (!_readNode(path[level], node)) return -1;
+    pos = _upperBound(node, separator);
+  }
+}
+
+// new root with the old root as child 0 and the child of entry as child 1
+int I2C_eeprom_btree::_newRoot(const uint8_t *entry, const bool last)
+{
+  uint8_t  node[_pageSize];
+  uint16_t rootPage = _nextFree++;
+  node[0] = 0;
+  node[1] = 1;
+  memcpy(node + 2, &_root, sizeof(uint16_t));
+  memcpy(node + I2C_EEPROM_BTREE_HEADER, entry, I2C_EEPROM_BTREE_INNER);
+  int rv = _writeNode(rootPage, node);
+  if (rv != 0) return rv;
+  _root = rootPage;
+  _height++;
+  if (last) _split = false;
+  return _writeMeta();
+}
+
+// A split writes the new node before the node split, which links it in
+// the leaf chain, so the chain always holds every record once. A reset
+// before the parent is written leaves leaves that find() does not reach,
+// these are added to their parent level as the split would have done.
+// The first leaf is never moved by a split.
+int I2C_eeprom_btree::_repair()
+{
+  uint8_t  leaf[_pageSize];
+  uint8_t  node[_pageSize];
+  uint16_t path[I2C_EEPROM_BTREE_DEPTH];
+  bool     rightmost;
+  uint8_t  entry[I2C_EEPROM_BTREE_INNER];
+  uint16_t page = _firstPage + 1;
+  for (uint16_t i = 0; (i < _pages) && (page != I2C_EEPROM_BTREE_NONE); i++)
+  {
+    if (!_readNode(page, leaf) || (leaf[0] != 1)) return -1;
+    if (leaf[1] > 0)
+    {
+      uint32_t first = _key(leaf, 0);
+      if (!_descend(first, node, path, &rightmost)) return -1;
+      if (path[_height - 1] != page)
+      {
+        if ((getFreePages() < _height + 1) || (_height == I2C_EEPROM_BTREE_DEPTH)) return -1;
+        memcpy(entry, &first, sizeof(uint32_t));
+        memcpy(entry + sizeof(uint32_t), &page, sizeof(uint16_t));
+        int rv;
+        if (_height == 1) rv = _newRoot(entry, false);
+        else
+        {
+          uint8_t level = _height - 2;
+          if (!_readNode(path[level], node)) return -1;
+          rv = _insertEntry(level, path, node, _upperBound(node, first), entry, rightmost, false);
+        }
+        if (rv != 0) return rv;
+      }
+    }
+    page = _child(leaf, 0);
+  }
+  _split = false;
+  return _writeMeta();
+}
+
+bool I2C_eeprom_btree::_readNode(const uint16_t page, uint8_t *node)
+{
+  int8_t idx = _cacheFind(page);
+  if (idx >= 0)
+  {
+    memcpy(node, _cache + idx * _pageSize, _pageSize);
+    _used[idx] = ++_tick;
+    _hits++;
+    return true;
+  }
+  if (_eeprom->readBlock(page * _pageSize, node, _nodeSize) != _nodeSize) return false;
+  _reads++;
+  // no garbage from a page that is not a node
+  if (node[0] > 1) return false;
+  if (node[1] > (node[0] ? _leafSlots : _innerSlots)) return false;
+  _cachePut(page, node);
+  return true;
+}
+
+// only the used part of the node is written, at most _nodeSize bytes
+int I2C_eeprom_btree::_writeNode(const uint16_t page, const uint8_t *node)
+{
+  uint16_t size = I2C_EEPROM_BTREE_HEADER + node[1] * _entrySize(node);
+  int rv = _eeprom->writeBlock(page * _pageSize, node, size);
+  if (page == _cursorPage) _cursorLoaded = false;
+  if (rv == 0) _cachePut(page, node);
+  else
+  {
+    int8_t idx = _cacheFind(page);
+    if (idx >= 0) _cached[idx] = I2C_EEPROM_BTREE_NONE;
+  }
+  return rv;
+}
+
+int I2C_eeprom_btree::_writeMeta()
+{
+  meta m;
+  memset(&m, 0, sizeof(m));
+  m.magic     = I2C_EEPROM_BTREE_MAGIC;
+  m.root      = _root;
+  m.nextFree  = _nextFree;
+  m.height    = _height;
+  m.valueSize = _valueSize;
+  m.split     = _split ? 1 : 0;
+  m.crc       = _crc8(0, (uint8_t *)&m, (uint8_t *)&m.crc - (uint8_t *)&m);
+  return _eeprom->writeBlock(_firstPage * _pageSize, (uint8_t *)&m, sizeof(m));
+}
+
+int8_t I2C_eeprom_btree::_cacheFind(const uint16_t page)
+{
+  for (uint8_t i = 0; i < _cachePages; i++)
+  {
+    if (_cached[i] == page) return i;
+  }
+  return -1;
+}
+
+// replaces the least recently used node, an empty entry first
+void I2C_eeprom_btree::_cachePut(const uint16_t page, const uint8_t *node)
+{
+  if (_cachePages == 0) return;
+
+  int8_t idx = _cacheFind(page);
+  if (idx < 0)
+  {
+    idx = 0;
+    for (uint8_t i = 0; i < _cachePages; i++)
+    {
+      if (_cached[i] == I2C_EEPROM_BTREE_NONE)
+      {
+        idx = i;
+        break;
+      }
+      if ((uint16_t)(_tick - _used[i]) > (uint16_t)(_tick - _used[idx])) idx = i;
+    }
+  }
+  _cached[idx] = page;
+  _used[idx]   = ++_tick;
+  memcpy(_cache + idx * _pageSize, node, _pageSize);
+}
+
+uint8_t I2C_eeprom_btree::_entrySize(const uint8_t *node)
+{
+  return node[0] ? sizeof(uint32_t) + _valueSize : I2C_EEPROM_BTREE_INNER;
+}
+
+uint32_t I2C_eeprom_btree::_key(const uint8_t *node, const uint8_t index)
+{
+  uint32_t key;
+  memcpy(&key, node + I2C_EEPROM_BTREE_HEADER + index * _entrySize(node), sizeof(key));
+  return key;
+}
+
+// child 0 is in the header, child i + 1 in entry i
+uint16_t I2C_eeprom_btree::_child(const uint8_t *node, const uint8_t index)
+{
+  uint16_t child;
+  if (index == 0) memcpy(&child, node + 2, sizeof(child));
+  else memcpy(&child, node + I2C_EEPROM_BTREE_HEADER + (index - 1) * I2C_EEPROM_BTREE_INNER + sizeof(uint32_t), sizeof(child));
+  return child;
+}
+
+// first entry with a key >= key
+uint8_t I2C_eeprom_btree::_lowerBound(const uint8_t *node, const uint32_t key)
+{
+  uint8_t lo = 0;
+  uint8_t hi = node[1];
+  while (lo < hi)
+  {
+    uint8_t mid = (lo + hi) / 2;
+    if (_key(node, mid) < key) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// first entry with a key > key, also the child to follow
+uint8_t I2C_eeprom_btree::_upperBound(const uint8_t *node, const uint32_t key)
+{
+  uint8_t lo = 0;
+  uint8_t hi = node[1];
+  while (lo < hi)
+  {
+    uint8_t mid = (lo + hi) / 2;
+    if (_key(node, mid) <= key) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// reads the nodes from the root to the leaf of key, node holds the leaf.
+// rightmost is true if the last child was followed on every level.
+bool I2C_eeprom_btree::_descend(const uint32_t key, uint8_t *node, uint16_t *path, bool *rightmost)
+{
+  uint16_t page = _root;
+  *rightmost = true;
+  for (uint8_t level = 0; level < _height; level++)
+  {
+    path[level] = page;
+    if (!_readNode(page, node)) return false;
+    // a leaf must be on the last level
+    if (node[0]) return (level == _height - 1);
+    uint8_t u = _upperBound(node, key);
+    if (u < node[1]) *rightmost = false;
+    page = _child(node, u);
+  }
+  return false;
+}
+
+uint8_t I2C_eeprom_btree::_crc8(uint8_t crc, const uint8_t *data, const uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
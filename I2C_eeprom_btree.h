@@ -0,0 +1,138 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_btree.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: B+tree index with one page per node for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// bytes of every node for { leaf, count, next / first child }
+#define I2C_EEPROM_BTREE_HEADER  4
+
+// maximum height of the tree
+#ifndef I2C_EEPROM_BTREE_DEPTH
+#define I2C_EEPROM_BTREE_DEPTH   8
+#endif
+
+// maximum number of cached nodes
+#ifndef I2C_EEPROM_BTREE_CACHE
+#define I2C_EEPROM_BTREE_CACHE   8
+#endif
+
+// no page, e.g. next of the last leaf
+#define I2C_EEPROM_BTREE_NONE    0xFFFF
+
+class I2C_eeprom_btree
+{
+public:
+  /**
+    * Sorted { key, value } records in a B+tree of which every node is
+    * one page. A node uses at most I2C_TWIBUFFERSIZE bytes of its page,
+    * so it is read or written in one transaction and one write cycle,
+    * on AVR (30 bytes) a 64 byte page holds a node of 30 bytes.
+    *
+    * The first page of the region holds the root and the number of
+    * pages in use, the nodes follow. The leaves are linked in key order
+    * for range queries. Nodes read are kept in a small LRU cache, so the
+    * upper levels of the tree are normally read from RAM.
+    *
+    * @param eeprom     The instance of I2C_eeprom to use.
+    * @param cache      Buffer of the caller of cachePages * getPageSize() bytes, may be NULL.
+    * @param cachePages Number of nodes in the cache, max I2C_EEPROM_BTREE_CACHE.
+    * @param firstPage  First page of the region.
+    * @param pages      Number of pages of the region.
+    * @param valueSize  Bytes of the value of a record.
+    * @return True if a tree was found, false if not (call format()),
+    *         if the parameters do not fit or if a split interrupted
+    *         by a reset could not be completed.
+    */
+  bool     begin(I2C_eeprom &eeprom, uint8_t *cache, const uint8_t cachePages,
+                 const uint16_t firstPage, const uint16_t pages, const uint8_t valueSize);
+
+  // writes an empty tree.
+  bool     format();
+
+  // adds a record or replaces the value of key.
+  // return 0 if OK, -1 if the region is full, error code otherwise.
+  // A split needs up to getHeight() + 1 free pages, -1 is returned if
+  // less than 2 * getHeight() + 1 are free, the rest is kept for begin()
+  // to complete a split interrupted by a reset.
+  int      insert(const uint32_t key, const void *value);
+  // reads the value of key, returns false if not found.
+  bool     find(const uint32_t key, void *value);
+
+  // range query, positions before the first key >= from.
+  // next() returns the records up to and including to in key order,
+  // without cache it reads a leaf header once and then one record per call.
+  bool     seek(const uint32_t from, const uint32_t to = 0xFFFFFFFF);
+  bool     next(uint32_t &key, void *value);
+
+  uint8_t  getHeight()     { return _height; };
+  // pages used, the first page included.
+  uint16_t getUsedPages()  { return _nextFree - _firstPage; };
+  uint16_t getFreePages()  { return _firstPage + _pages - _nextFree; };
+  uint8_t  getLeafSlots()  { return _leafSlots; };
+  uint8_t  getInnerSlots() { return _innerSlots; };
+  // node reads from the cache and from the eeprom, for diagnostics.
+  uint32_t getCacheHits()  { return _hits; };
+  uint32_t getNodeReads()  { return _reads; };
+
+private:
+  struct meta
+  {
+    uint32_t magic;
+    uint16_t root;
+    uint16_t nextFree;
+    uint8_t  height;
+    uint8_t  valueSize;
+    uint8_t  split;
+    uint8_t  crc;
+  };
+
+  I2C_eeprom * _eeprom = NULL;
+  uint8_t  * _cache;
+  uint8_t  _cachePages;
+  uint16_t _cached[I2C_EEPROM_BTREE_CACHE];   // page of every cache entry
+  uint16_t _used[I2C_EEPROM_BTREE_CACHE];     // LRU stamps
+  uint16_t _tick;
+  uint16_t _firstPage;
+  uint16_t _pages;
+  uint8_t  _pageSize;
+  uint8_t  _nodeSize;    // bytes of a page used by a node
+  uint8_t  _valueSize;
+  uint8_t  _leafSlots;
+  uint8_t  _innerSlots;
+  uint16_t _root;
+  uint16_t _nextFree;
+  uint8_t  _height;
+  bool     _split;     // a split is not completed yet
+  uint32_t _hits;
+  uint32_t _reads;
+  uint16_t _cursorPage;
+  uint8_t  _cursorIndex;
+  uint32_t _cursorTo;
+  uint8_t  _cursorCount;
+  uint16_t _cursorNext;
+  bool     _cursorLoaded;   // count and next of the cursor leaf are read
+
+  bool     _readNode(const uint16_t page, uint8_t *node);
+  int      _writeNode(const uint16_t page, const uint8_t *node);
+  int      _writeMeta();
+  int8_t   _cacheFind(const uint16_t page);
+  void     _cachePut(const uint16_t page, const uint8_t *node);
+  uint8_t  _entrySize(const uint8_t *node);
+  uint32_t _key(const uint8_t *node, const uint8_t index);
+  uint16_t _child(const uint8_t *node, const uint8_t index);
+  uint8_t  _lowerBound(const uint8_t *node, const uint32_t key);
+  uint8_t  _upperBound(const uint8_t *node, const uint32_t key);
+  int      _insertEntry(uint8_t level, uint16_t *path, uint8_t *node, uint8_t pos,
+                        uint8_t *entry, const bool rightmost, const bool last);
+  int      _newRoot(const uint8_t *entry, const bool last);
+  int      _repair();
+  bool     _descend(const uint32_t key, uint8_t *node, uint16_t *path, bool *rightmost);
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint8_t length);
+};
+
+// -- END OF FILE --
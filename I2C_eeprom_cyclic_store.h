@@ -7,6 +7,38 @@
 //
 
 #include <I2C_eeprom.h>
+#include <I2C_eeprom_partition.h>
+
+/**
+ * @brief Interface of a store that can take part in an
+ * I2C_eeprom_transaction.
+ *
+ * A participant keeps the previous versions of its data when it is written,
+ * so the transaction only has to record the versions of all participants
+ * in a commit record and can revert to them after a reset.
+ */
+class I2C_eeprom_transactional
+{
+public:
+    /**
+      * @return The version of the current data, 0xFFFFFFFF if empty.
+      */
+    virtual uint32_t getVersion() const = 0;
+
+    /**
+      * @brief Makes an earlier version, that is still stored, current.
+      *
+      * @param version The version to revert to, 0xFFFFFFFF for empty.
+      * @return True if successful, false if the version is overwritten.
+      */
+    virtual bool revert(uint32_t version) = 0;
+
+protected:
+    friend class I2C_eeprom_transaction;
+    // Set when added to a transaction, writes must then keep the
+    // previous version intact.
+    bool _transactional = false;
+};
 
 /**
  * @brief This is a utility class for using an eeprom to store a simple
@@ -32,15 +64,22 @@
  * If the data structure has changed or if the eeprom contains other data it
  * must first be formatted with a call to format().
  * 
+ * Optionally a delta mode can be enabled, see enableDelta(), where each
+ * slot has a delta area after the data structure. Writes that change
+ * only a few bytes are then appended to the delta area of the current
+ * slot as a small record instead of writing a full new version.
+ *
  * Finally, since the version number is a long word, this class will
  * *derail and fail* to add new versions past 4294967295 writes.
  * 
  * @tparam T the type of the data structure to store, should only contain
  * **value** members and no constructor/destructor nor other
  * methods/functions - e g a pure DTO.
+ * @tparam EEPROM the eeprom class, only to be replaced by a fake with the
+ * same interface for testing.
  */
-template <typename T>
-class I2C_eeprom_cyclic_store
+template <typename T, typename EEPROM = I2C_eeprom>
+class I2C_eeprom_cyclic_store : public I2C_eeprom_transactional
 {
 public:
     /**
@@ -54,19 +93,109 @@ public:
       * @param totalPages Specifies the total number of pages to use.
       * Specifying a number that is less than the available pages will
       * exclude the remaining pages from being used.
+      * @param firstPage The first page of the region to use, allows
+      * several stores to share one eeprom.
       * @return True if initialization succeeds, false otherwise.
       */
-    bool begin(I2C_eeprom &eeprom, uint8_t pageSize, uint16_t totalPages)
+    bool begin(EEPROM &eeprom, uint8_t pageSize, uint16_t totalPages, uint16_t firstPage = 0)
     {
         _eeprom = &eeprom;
         _pageSize = pageSize;
         _totalPages = totalPages;
+        _firstPage = firstPage;
+        _shadowValid = false;
         auto bufferSize = sizeof(_currentVersion) + sizeof(T);
-        _bufferPages = bufferSize / _pageSize + (bufferSize % _pageSize ? 1 : 0);
+        _bufferPages = bufferSize / _pageSize + (bufferSize % _pageSize ? 1 : 0) + _deltaPages;
 
         return (_bufferPages < _totalPages) && initialize();
     };
 
+    /**
+      * @brief Enables delta mode, must be called before begin().
+      *
+      * In delta mode every slot is followed by \p deltaPages pages for
+      * delta records. A write() compares the new data with the shadow copy
+      * and appends the changed byte ranges as one record to the delta area
+      * of the current slot. Only if the delta area is full or the changes
+      * are too large (more than half of T) a full version is written to
+      * the next slot. On begin() the full version is read and the records
+      * of the current slot are replayed into the shadow copy, read() then
+      * copies from the shadow copy.
+      *
+      * Note that the pages of the delta area are written more often than
+      * the pages holding the full versions.
+      *
+      * @param shadow Buffer of the caller that holds the latest value.
+      * @param deltaPages The number of pages for delta records per slot.
+      */
+    void enableDelta(T &shadow, uint8_t deltaPages)
+    {
+        _shadow = &shadow;
+        _shadowValid = false;
+        _deltaPages = deltaPages;
+    }
+
+    /**
+      * @brief Enables writing the header last.
+      *
+      * By default the header with the new version is written together
+      * with the start of the data. If the data spans several write
+      * transactions, a reset in between leaves a slot with a new
+      * version but partly old data which begin() accepts as latest.
+      *
+      * With header last the transactions after the first are written
+      * first and the one holding the header last, so a slot only gets
+      * its new version once all data is written. The number of write
+      * cycles stays the same.
+      *
+      * @param headerLast True to write the header last.
+      */
+    void setHeaderLast(bool headerLast)
+    {
+        _headerLast = headerLast;
+    }
+
+    /**
+      * @brief Enables a RAM cache of the current value.
+      *
+      * By default read() reads sizeof(T) bytes from the eeprom on every
+      * call, which costs no RAM. With a cache the value is read once and
+      * kept coherent by write() and format(), read() then is a memcpy.
+      * The cache is a buffer of the caller so its RAM cost is explicit,
+      * on RAM constrained targets simply do not enable it.
+      *
+      * In delta mode the shadow copy already acts as cache.
+      *
+      * @param cache Buffer of the caller that holds the current value.
+      */
+    void enableCache(T &cache)
+    {
+        if (_deltaPages > 0)
+            return;
+        _shadow = &cache;
+        _shadowValid = false;
+    }
+
+    /**
+      * @brief Initializes the instance on a named partition
+      *
+      * The partition must have been added to the table, see
+      * I2C_eeprom_partition_table::add().
+      *
+      * @param table The partition table of the eeprom, must be loaded.
+      * @param name The name of the partition to use.
+      * @return True if the partition exists and initialization
+      * succeeds, false otherwise.
+      */
+    bool begin(I2C_eeprom_partition_table &table, const char *name)
+    {
+        uint16_t firstPage, pages;
+        if (table.getEEPROM() == NULL || !table.find(name, firstPage, pages))
+            return false;
+
+        return begin(*table.getEEPROM(), table.getEEPROM()->getPageSize(), pages, firstPage);
+    }
+
     /**
       * @brief Formats the eeprom
       * 
@@ -82,15 +211,26 @@ public:
     {
         // Reset the EEPROM by writing a ~0 into all pages
         auto totalSlots = _totalPages / _bufferPages;
-        auto slotSize = _pageSize * _bufferPages;
         for (uint16_t slot = 0; slot < totalSlots; slot++)
         {
-            if(_eeprom->writeBlock(slot * slotSize, (uint8_t *)"\xff\xff\xff\xff", 4) != 0)
+            if(_eeprom->writeBlock(slotAddress(slot), (uint8_t *)"\xff\xff\xff\xff", 4) != 0)
                 return false;
         }
 
+        // Old delta records could match the restarted version numbers
+        if (_deltaPages > 0)
+        {
+            for (uint16_t slot = 0; slot < totalSlots; slot++)
+            {
+                if(_eeprom->erase(deltaAddress(slot), _deltaPages * _pageSize) != 0)
+                    return false;
+            }
+        }
+
         _isEmpty = true;
+        _shadowValid = false;
         _currentSlot = 0;
+        _deltaOffset = 0;
         _isInitialized = true;
 
 	return true;
@@ -122,7 +262,21 @@ public:
         if (_isEmpty)
             return false;
 
-        return _eeprom->readBlock((_currentSlot * _bufferPages * _pageSize) + sizeof(_currentVersion), (uint8_t *)buffer, sizeof(T)) == sizeof(T);
+        if (_shadowValid)
+        {
+            memcpy(buffer, _shadow, sizeof(T));
+            return true;
+        }
+
+        if (_eeprom->readBlock(slotAddress(_currentSlot) + sizeof(_currentVersion), (uint8_t *)buffer, sizeof(T)) != sizeof(T))
+            return false;
+
+        if (_shadow != NULL)
+        {
+            memcpy(_shadow, buffer, sizeof(T));
+            _shadowValid = true;
+        }
+        return true;
     }
 
     /**
@@ -149,6 +303,13 @@ public:
             return false;
         }
 
+        // A delta needs a shadow copy of the current version, after a
+        // failed write or read a full version is written instead
+        if (_deltaPages > 0 && !_isEmpty && _shadowValid && !_transactional && writeDelta(buffer))
+        {
+            return true;
+        }
+
         if (_isEmpty)
         {
             _currentSlot = 0;
@@ -164,6 +325,7 @@ public:
             if (_currentSlot >= maxSlots)
                 _currentSlot = 0;
         }
+        _deltaOffset = 0;
 
         auto buffer_length = sizeof(_currentVersion) + sizeof(T);
         uint8_t tmp[buffer_length];
@@ -171,10 +333,32 @@ public:
         memcpy(tmp, &_currentVersion, sizeof(_currentVersion));
         memcpy(tmp + sizeof(_currentVersion), buffer, sizeof(T));
 
-        auto success = _eeprom->writeBlock(_currentSlot * _bufferPages * _pageSize, tmp, buffer_length) == 0;
+        bool success;
+        uint16_t first = _pageSize < I2C_TWIBUFFERSIZE ? _pageSize : I2C_TWIBUFFERSIZE;
+        if (_headerLast && buffer_length > first)
+        {
+            // The first transaction holds the header, write it last
+            success = _eeprom->writeBlock(slotAddress(_currentSlot) + first, tmp + first, buffer_length - first) == 0
+                && _eeprom->writeBlock(slotAddress(_currentSlot), tmp, first) == 0;
+        }
+        else
+        {
+            success = _eeprom->writeBlock(slotAddress(_currentSlot), tmp, buffer_length) == 0;
+        }
 
         if (success)
+        {
             _isEmpty = false;
+            if (_shadow != NULL)
+            {
+                memcpy(_shadow, buffer, sizeof(T));
+                _shadowValid = true;
+            }
+        }
+        else
+        {
+            _shadowValid = false;
+        }
 
         return success;
     }
@@ -201,30 +385,314 @@ public:
         return true;
     }
 
+    /**
+      * @brief Returns the version of the current slot.
+      *
+      * @return The version, 0xFFFFFFFF if empty or not initialized.
+      */
+    uint32_t getVersion() const
+    {
+        if (!_isInitialized || _isEmpty)
+            return 0xffffffff;
+        return _currentVersion;
+    }
+
+    /**
+      * @brief Makes an earlier version current again.
+      *
+      * This is possible as long as the slot of that version has not been
+      * reused, i.e. fewer writes than slots have been done since. The
+      * next write overwrites the newer versions.
+      *
+      * @param version The version to revert to, 0xFFFFFFFF for empty.
+      * @return True if successful, false otherwise.
+      */
+    bool revert(uint32_t version)
+    {
+        if (!_isInitialized)
+            return false;
+
+        if (version == getVersion())
+            return true;
+
+        if (_isEmpty || (version != 0xffffffff && version > _currentVersion))
+            return false;
+
+        if (version == 0xffffffff)
+        {
+            _isEmpty = true;
+            _currentSlot = 0;
+            _currentVersion = 0;
+            _deltaOffset = 0;
+            _shadowValid = false;
+            return true;
+        }
+
+        uint16_t slots = _totalPages / _bufferPages;
+        uint32_t back = _currentVersion - version;
+        if (back >= slots)
+            return false;
+
+        uint16_t slot = (_currentSlot + slots - back) % slots;
+        uint32_t stored;
+        if (_eeprom->readBlock(slotAddress(slot), (uint8_t *)&stored, sizeof(stored)) != sizeof(stored) || stored != version)
+            return false;
+
+        _currentSlot = slot;
+        _currentVersion = version;
+        _deltaOffset = 0;
+        _shadowValid = false;
+
+        return _deltaPages == 0 || replayDelta();
+    }
+
+    /**
+      * @brief Returns metrics of the last mount done by begin().
+      *
+      * When several slot headers fit in one TWI buffer, i.e. for small
+      * slots, they are read in a single transaction which reduces the
+      * number of reads of the binary search.
+      *
+      * @param[out] duration The duration of the mount in microseconds.
+      * @param[out] reads The number of header reads.
+      */
+    void getMountMetrics(uint32_t &duration, uint16_t &reads)
+    {
+        duration = _mountTime;
+        reads = _mountReads;
+    }
+
 private:
     uint8_t _pageSize;
+    uint16_t _firstPage;
     uint16_t _bufferPages;
     uint16_t _totalPages;
     uint16_t _currentSlot;
     uint32_t _currentVersion;
     bool _isInitialized = false;
     bool _isEmpty = false;
-    I2C_eeprom *_eeprom;
+    bool _headerLast = false;
+    EEPROM *_eeprom;
+
+    // Delta mode, a record is { version, size, { offset, length, data }..., crc8 }
+    static const uint16_t DELTA_HEADER = sizeof(uint32_t) + sizeof(uint16_t);
+    static const uint16_t DELTA_MAX = sizeof(T) / 2 + 16;
+    T *_shadow = NULL;
+    mutable bool _shadowValid = false;
+    uint32_t _mountTime = 0;
+    uint16_t _mountReads = 0;
+    uint8_t _deltaPages = 0;
+    uint16_t _deltaOffset = 0;
+
+    uint16_t slotAddress(uint16_t slot) const
+    {
+        return (_firstPage + slot * _bufferPages) * _pageSize;
+    }
+
+    uint16_t deltaAddress(uint16_t slot) const
+    {
+        return slotAddress(slot) + (_bufferPages - _deltaPages) * _pageSize;
+    }
+
+    static uint8_t crc8(const uint8_t *data, uint16_t length)
+    {
+        uint8_t crc = 0;
+        while (length--)
+        {
+            crc ^= *data++;
+            for (uint8_t b = 0; b < 8; b++)
+                crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+        }
+        return crc;
+    }
+
+    /**
+      * Appends the changes between the shadow copy and buffer to the
+      * delta area of the current slot.
+      *
+      * @return True if written (or unchanged), false if a full version
+      * must be written instead.
+      */
+    bool writeDelta(const T *buffer)
+    {
+        const uint8_t *next = (const uint8_t *)buffer;
+        const uint8_t *last = (const uint8_t *)_shadow;
+        uint8_t record[DELTA_MAX];
+        uint16_t size = DELTA_HEADER;
+
+        uint16_t i = 0;
+        while (i < sizeof(T))
+        {
+            if (next[i] == last[i])
+            {
+                i++;
+                continue;
+            }
+
+            // Join changes separated by fewer bytes than a segment header
+            uint16_t start = i, end = i + 1;
+            for (uint16_t j = end; j < sizeof(T) && j - start < 255 && j - end < 3; j++)
+            {
+                if (next[j] != last[j])
+                    end = j + 1;
+            }
+
+            uint8_t length = end - start;
+            if (size + 3 + length + 1 > DELTA_MAX)
+                return false;
+
+            memcpy(record + size, &start, sizeof(start));
+            record[size + 2] = length;
+            memcpy(record + size + 3, next + start, length);
+            size += 3 + length;
+            i = end;
+        }
+
+        if (size == DELTA_HEADER)
+            return true;
+
+        size++;
+        memcpy(record, &_currentVersion, sizeof(_currentVersion));
+        memcpy(record + sizeof(_currentVersion), &size, sizeof(size));
+        record[size - 1] = crc8(record, size - 1);
+
+        // Avoid a second write cycle for records that fit in a page
+        uint16_t offset = _deltaOffset;
+        if (size <= _pageSize && (offset % _pageSize) + size > _pageSize)
+            offset += _pageSize - (offset % _pageSize);
+        if (offset + size > _deltaPages * _pageSize)
+            return false;
+
+        if (_eeprom->writeBlock(deltaAddress(_currentSlot) + offset, record, size) != 0)
+            return false;
+
+        _deltaOffset = offset + size;
+        memcpy(_shadow, buffer, sizeof(T));
+        return true;
+    }
+
+    /**
+      * Reads the full version of the current slot into the shadow copy
+      * and applies the delta records that belong to it.
+      */
+    bool replayDelta()
+    {
+        if (_eeprom->readBlock(slotAddress(_currentSlot) + sizeof(_currentVersion), (uint8_t *)_shadow, sizeof(T)) != sizeof(T))
+            return false;
+
+        uint8_t record[DELTA_MAX];
+        uint16_t areaSize = _deltaPages * _pageSize;
+        uint16_t offset = 0;
+        bool skipped = false;
+        _deltaOffset = 0;
+
+        while (offset + DELTA_HEADER < areaSize)
+        {
+            uint32_t version;
+            uint16_t size = 0;
+            bool valid = _eeprom->readBlock(deltaAddress(_currentSlot) + offset, record, DELTA_HEADER) == DELTA_HEADER;
+            if (valid)
+            {
+                memcpy(&version, record, sizeof(version));
+                memcpy(&size, record + sizeof(version), sizeof(size));
+                valid = version == _currentVersion && size > DELTA_HEADER && size <= DELTA_MAX && offset + size <= areaSize;
+            }
+            if (valid)
+            {
+                uint16_t rest = size - DELTA_HEADER;
+                valid = _eeprom->readBlock(deltaAddress(_currentSlot) + offset + DELTA_HEADER, record + DELTA_HEADER, rest) == rest
+                    && crc8(record, size - 1) == record[size - 1];
+            }
+
+            if (!valid)
+            {
+                // The writer moves to the next page if a record does not fit
+                if (skipped || offset % _pageSize == 0)
+                    break;
+                offset += _pageSize - (offset % _pageSize);
+                skipped = true;
+                continue;
+            }
+
+            for (uint16_t i = DELTA_HEADER; i + 3 < size - 1; )
+            {
+                uint16_t start;
+                memcpy(&start, record + i, sizeof(start));
+                uint8_t length = record[i + 2];
+                if (start + length > sizeof(T))
+                    break;
+                memcpy((uint8_t *)_shadow + start, record + i + 3, length);
+                i += 3 + length;
+            }
+
+            offset += size;
+            _deltaOffset = offset;
+            skipped = false;
+        }
+        _shadowValid = true;
+        return true;
+    }
 
     bool initialize()
     {
-        uint16_t startSlot, probeSlot, endSlot;
+        unsigned long start = micros();
+        _mountReads = 0;
+        bool success = mount();
+        _mountTime = micros() - start;
+        return success;
+    }
+
+    /**
+      * Reads the headers of count consecutive slots. If the headers fit
+      * in one TWI buffer they are fetched with a single read.
+      */
+    bool readHeaders(uint16_t firstSlot, uint16_t count, uint32_t *headers)
+    {
+        _mountReads++;
+        if (count == 1)
+            return _eeprom->readBlock(slotAddress(firstSlot), (uint8_t *)headers, sizeof(uint32_t)) == sizeof(uint32_t);
+
+        uint8_t buffer[I2C_TWIBUFFERSIZE];
+        uint16_t slotSize = _bufferPages * _pageSize;
+        uint16_t length = (count - 1) * slotSize + sizeof(uint32_t);
+        if (_eeprom->readBlock(slotAddress(firstSlot), buffer, length) != length)
+            return false;
+
+        for (uint16_t i = 0; i < count; i++)
+            memcpy(&headers[i], buffer + i * slotSize, sizeof(uint32_t));
+        return true;
+    }
+
+    bool mount()
+    {
+        // Slots are searched in groups of consecutive slots whose headers
+        // can be read in one transaction, only small slots share a group.
+        static const uint16_t MAX_GROUP = (I2C_TWIBUFFERSIZE - sizeof(uint32_t)) / 8 + 1;
+        uint32_t headers[MAX_GROUP];
+        uint16_t slots = _totalPages / _bufferPages;
+        uint16_t slotSize = _bufferPages * _pageSize;
+        uint16_t perGroup = 1;
+        if (slotSize + sizeof(uint32_t) <= I2C_TWIBUFFERSIZE)
+            perGroup = (I2C_TWIBUFFERSIZE - sizeof(uint32_t)) / slotSize + 1;
+        if (perGroup > MAX_GROUP)
+            perGroup = MAX_GROUP;
+        if (perGroup > slots)
+            perGroup = slots;
+
+        uint16_t startGroup, probeGroup, endGroup;
         uint32_t current, probe;
-        auto slotSize = _pageSize * _bufferPages;
 
-        startSlot = 0;
-        endSlot = (_totalPages / _bufferPages) - 1;          // Index of last slot
-        probeSlot = startSlot + ((endSlot - startSlot) / 2); // Midway between start and end
+        startGroup = 0;
+        endGroup = (slots + perGroup - 1) / perGroup - 1;             // Index of last group
+        probeGroup = startGroup + ((endGroup - startGroup) / 2);      // Midway between start and end
+        if (probeGroup == startGroup)
+            probeGroup = endGroup;                                    // Two groups, probe the last one
 
-        if(_eeprom->readBlock(0, (uint8_t *)&current, sizeof(current)) != sizeof(current))
+        if (!readHeaders(0, perGroup, headers))
         {
             return false;
         }
+        current = headers[0];
 
         if (current == 0xffffffff)
         {
@@ -236,9 +704,20 @@ private:
             return true;
         }
 
-        while (startSlot != probeSlot)
+        // A drop inside the first group means the search is done already
+        for (uint16_t i = 1; i < perGroup; i++)
         {
-            if(_eeprom->readBlock(probeSlot * slotSize, (uint8_t *)&probe, sizeof(current)) != sizeof(current))
+            if (headers[i] == 0xffffffff || headers[i] <= headers[i - 1])
+            {
+                endGroup = 0;
+                probeGroup = 0;
+                break;
+            }
+        }
+
+        while (startGroup != probeGroup)
+        {
+            if (!readHeaders(probeGroup * perGroup, 1, &probe))
             {
                 return false;
             }
@@ -247,21 +726,42 @@ private:
             {
                 // 1. Nothing has been written to the memory at Probe
                 // 2. The slots have the same timestamp, this shouldn't happen, treat as if Probe slot hasn't been written
-                // 3. Probe is older that Start, change End to slot before Probe
-                endSlot = probeSlot-1;
+                // 3. Probe is older that Start, change End to group before Probe
+                endGroup = probeGroup-1;
             }
             else
             {
                 // 1. Probe is later than Start, change Start to Probe
-                startSlot = probeSlot;
+                startGroup = probeGroup;
                 current = probe;
             }
-            probeSlot = startSlot + ((endSlot - startSlot + 1) / 2);
+            probeGroup = startGroup + ((endGroup - startGroup + 1) / 2);
+        }
+
+        // The latest version is in startGroup, find it within the group
+        uint16_t startSlot = startGroup * perGroup;
+        uint16_t count = slots - startSlot;
+        if (count > perGroup)
+            count = perGroup;
+        if (startGroup != 0 && count > 1 && !readHeaders(startSlot, count, headers))
+        {
+            return false;
+        }
+        for (uint16_t i = 1; i < count; i++)
+        {
+            if (headers[i] == 0xffffffff || headers[i] <= current)
+                break;
+            startSlot++;
+            current = headers[i];
         }
 
         _currentSlot = startSlot;
         _currentVersion = current;
         _isEmpty = false;
+
+        if (_deltaPages > 0 && !replayDelta())
+            return false;
+
         _isInitialized = true;
 
         return true;
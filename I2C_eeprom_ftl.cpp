@@ -0,0 +1,235 @@
+//
+//    FILE: I2C_eeprom_ftl.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Wear leveling page translation layer for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// physical page { seq, logical, crc8, payload } * pages
+//
+// A write goes to a free page with the next seq, the previous copy stays
+// until its page is reused. begin() takes the copy with the highest seq
+// and a valid crc, so a torn write falls back to the previous copy.
+
+
+#include <I2C_eeprom_ftl.h>
+
+#define I2C_EEPROM_FTL_ERASED  0xFFFFFFFF
+
+
+bool I2C_eeprom_ftl::begin(I2C_eeprom &eeprom, uint16_t *map, const uint16_t firstPage,
+                           const uint16_t pages, const uint16_t spares)
+{
+  if (map == NULL || spares == 0 || spares >= pages) return false;
+  if (eeprom.getPageSize() <= I2C_EEPROM_FTL_HEADER) return false;
+
+  _eeprom       = &eeprom;
+  _map          = map;
+  _used         = (uint8_t *)(map + pages - spares);
+  _firstPage    = firstPage;
+  _pages        = pages;
+  _logicalPages = pages - spares;
+  _pageSize     = eeprom.getPageSize();
+  _payload      = _pageSize - I2C_EEPROM_FTL_HEADER;
+  _head         = 0;
+  _seq          = 0;
+  _writes       = 0;
+  _relocations  = 0;
+  memset(_map, 0xFF, _logicalPages * sizeof(uint16_t));
+  memset(_used, 0, (pages + 7) / 8);
+
+  uint8_t page[_pageSize];
+  for (uint16_t i = 0; i < _pages; i++)
+  {
+    if (_eeprom->readBlock(_pageAddress(i), page, _pageSize) != _pageSize) return false;
+
+    uint32_t seq;
+    uint16_t logical;
+    memcpy(&seq, page, sizeof(seq));
+    memcpy(&logical, page + 4, sizeof(logical));
+    if (seq == I2C_EEPROM_FTL_ERASED || logical >= _logicalPages) continue;
+    if (_crc8(_crc8(0, page, 6), page + I2C_EEPROM_FTL_HEADER, _payload) != page[6]) continue;
+
+    uint16_t current = _map[logical];
+    if (current != I2C_EEPROM_FTL_NONE)
+    {
+      uint32_t currentSeq;
+      if (_eeprom->readBlock(_pageAddress(current), (uint8_t *)&currentSeq, sizeof(currentSeq)) != sizeof(currentSeq)) return false;
+      if (currentSeq > seq) continue;
+      _setUsed(current, false);
+    }
+    _map[logical] = i;
+    _setUsed(i, true);
+
+    if (seq > _seq)
+    {
+      _seq  = seq;
+      _head = (i + 1) % _pages;
+    }
+  }
+  return true;
+}
+
+bool I2C_eeprom_ftl::format()
+{
+  if (_eeprom == NULL) return false;
+  for (uint16_t i = 0; i < _pages; i++)
+  {
+    if (_eeprom->writeBlock(_pageAddress(i), (uint8_t *)"\xff\xff\xff\xff", 4) != 0) return false;
+  }
+  memset(_map, 0xFF, _logicalPages * sizeof(uint16_t));
+  memset(_used, 0, (_pages + 7) / 8);
+  _head = 0;
+  _seq  = 0;
+  return true;
+}
+
+uint16_t I2C_eeprom_ftl::read(const uint16_t address, uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return 0;
+
+  uint16_t done = 0;
+  while (done < length)
+  {
+    uint32_t addr = (uint32_t)address + done;
+    if (addr >= getLogicalSize()) break;
+
+    uint16_t logical = addr / _payload;
+    uint8_t  offset  = addr % _payload;
+    uint16_t cnt = _payload - offset;
+    if (cnt > length - done) cnt = length - done;
+
+    uint16_t p = _map[logical];
+    if (p == I2C_EEPROM_FTL_NONE)
+    {
+      memset(buffer + done, 0xFF, cnt);
+    }
+    else if (_eeprom->readBlock(_pageAddress(p) + I2C_EEPROM_FTL_HEADER + offset, buffer + done, cnt) != cnt)
+    {
+      break;
+    }
+    done += cnt;
+  }
+  return done;
+}
+
+int I2C_eeprom_ftl::write(const uint16_t address, const uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return -1;
+  if ((uint32_t)address + length > getLogicalSize()) return -1;
+
+  uint8_t  page[_pageSize];
+  uint16_t done = 0;
+  while (done < length)
+  {
+    uint16_t logical = (address + done) / _payload;
+    uint8_t  offset  = (address + done) % _payload;
+    uint16_t cnt = _payload - offset;
+    if (cnt > length - done) cnt = length - done;
+
+    uint16_t p = _map[logical];
+    if (p == I2C_EEPROM_FTL_NONE)
+    {
+      memset(page, 0xFF, _pageSize);
+    }
+    else if (_eeprom->readBlock(_pageAddress(p), page, _pageSize) != _pageSize)
+    {
+      return -1;
+    }
+
+    if (memcmp(page + I2C_EEPROM_FTL_HEADER + offset, buffer + done, cnt) != 0)
+    {
+      memcpy(page + I2C_EEPROM_FTL_HEADER + offset, buffer + done, cnt);
+      uint16_t cold;
+      int rv = _writePage(logical, page, cold);
+      if (rv != 0) return rv;
+
+      // cold was passed over by the whole previous round
+      if (_staticInterval > 0 && ++_writes >= _staticInterval
+          && cold != I2C_EEPROM_FTL_NONE && _isUsed(cold))
+      {
+        if (_eeprom->readBlock(_pageAddress(cold), page, _pageSize) != _pageSize) return -1;
+        uint16_t moved;
+        memcpy(&moved, page + 4, sizeof(moved));
+        rv = _writePage(moved, page, cold);
+        if (rv != 0) return rv;
+        _writes = 0;
+        _relocations++;
+      }
+    }
+    done += cnt;
+  }
+  return 0;
+}
+
+uint16_t I2C_eeprom_ftl::getPhysicalPage(const uint16_t logical)
+{
+  if (_eeprom == NULL || logical >= _logicalPages) return I2C_EEPROM_FTL_NONE;
+  return _map[logical];
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+void I2C_eeprom_ftl::_setUsed(const uint16_t index, const bool used)
+{
+  if (used) _used[index >> 3] |= (1 << (index & 7));
+  else      _used[index >> 3] &= ~(1 << (index & 7));
+}
+
+// first free page from the head, cold is the first used page passed.
+uint16_t I2C_eeprom_ftl::_nextFree(uint16_t &cold)
+{
+  cold = I2C_EEPROM_FTL_NONE;
+  for (uint16_t i = 0; i < _pages; i++)
+  {
+    uint16_t index = (_head + i) % _pages;
+    if (!_isUsed(index)) return index;
+    if (cold == I2C_EEPROM_FTL_NONE) cold = index;
+  }
+  return I2C_EEPROM_FTL_NONE;
+}
+
+// writes page with a new header to the next free page and maps it.
+int I2C_eeprom_ftl::_writePage(const uint16_t logical, uint8_t *page, uint16_t &cold)
+{
+  uint16_t p = _nextFree(cold);
+  if (p == I2C_EEPROM_FTL_NONE) return -1;
+
+  uint32_t seq = _seq + 1;
+  memcpy(page, &seq, sizeof(seq));
+  memcpy(page + 4, &logical, sizeof(logical));
+  page[6] = _crc8(_crc8(0, page, 6), page + I2C_EEPROM_FTL_HEADER, _payload);
+
+  int rv = _eeprom->writeBlock(_pageAddress(p), page, _pageSize);
+  if (rv != 0) return rv;
+
+  _seq = seq;
+  uint16_t old = _map[logical];
+  if (old != I2C_EEPROM_FTL_NONE) _setUsed(old, false);
+  _map[logical] = p;
+  _setUsed(p, true);
+  _head = (p + 1) % _pages;
+  return 0;
+}
+
+uint8_t I2C_eeprom_ftl::_crc8(uint8_t crc, const uint8_t *data, const uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
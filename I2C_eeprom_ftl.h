@@ -0,0 +1,94 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_ftl.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Wear leveling page translation layer for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// bytes of every physical page used for { seq, logical, crc8 }
+#define I2C_EEPROM_FTL_HEADER     7
+
+// uint16_t entries needed for the map of a region,
+// one per logical page plus one bit per physical page.
+#define I2C_EEPROM_FTL_MAPSIZE(pages, spares)  ((pages) - (spares) + ((pages) + 15) / 16)
+
+// logical page that is not written yet / no page
+#define I2C_EEPROM_FTL_NONE       0xFFFF
+
+class I2C_eeprom_ftl
+{
+public:
+  /**
+    * Maps logical pages to physical pages of a region of the EEPROM.
+    *
+    * Every write of a logical page goes to the next free physical
+    * page, so writes to a fixed address are spread over the region.
+    * Each physical page holds a header with a sequence number and its
+    * logical page, begin() rebuilds the map from these headers, so the
+    * map needs no separate storage and a reset during a write leaves
+    * the previous copy of the page in place.
+    *
+    * The logical pages are I2C_EEPROM_FTL_HEADER bytes smaller than
+    * the physical pages.
+    *
+    * @param eeprom    The instance of I2C_eeprom to use.
+    * @param map       Buffer of the caller of I2C_EEPROM_FTL_MAPSIZE(pages, spares) entries.
+    * @param firstPage First physical page of the region.
+    * @param pages     Number of physical pages of the region.
+    * @param spares    Physical pages not available as logical pages, one or more.
+    * @return True if the region was mounted, false otherwise.
+    */
+  bool     begin(I2C_eeprom &eeprom, uint16_t *map, const uint16_t firstPage,
+                 const uint16_t pages, const uint16_t spares);
+
+  // forgets all logical pages, one write per physical page.
+  bool     format();
+
+  // reads length bytes at logical address, unwritten pages read as 0xFF.
+  // returns bytes read
+  uint16_t read(const uint16_t address, uint8_t *buffer, const uint16_t length);
+  // writes length bytes at logical address, pages that do not change are skipped.
+  // return 0 if OK, -1 if out of range or no free page, error code otherwise.
+  int      write(const uint16_t address, const uint8_t *buffer, const uint16_t length);
+
+  // after this many page writes, also move one page that was not written
+  // during the last round over the region, so rarely written pages free
+  // their physical page for the others. 0 = off, default 8.
+  void     setStaticInterval(const uint8_t writes) { _staticInterval = writes; };
+  uint8_t  getStaticInterval()  { return _staticInterval; };
+
+  uint16_t getLogicalPages()    { return _logicalPages; };
+  uint8_t  getPayloadSize()     { return _payload; };
+  uint32_t getLogicalSize()     { return (uint32_t)_logicalPages * _payload; };
+  // physical page of a logical page, I2C_EEPROM_FTL_NONE if not written.
+  uint16_t getPhysicalPage(const uint16_t logical);
+  // number of page writes done to relocate rarely written pages.
+  uint32_t getRelocations()     { return _relocations; };
+
+private:
+  I2C_eeprom * _eeprom = NULL;
+  uint16_t * _map;          // logical -> physical index
+  uint8_t  * _used;         // bitmap of physical pages in use
+  uint16_t _firstPage;
+  uint16_t _pages;
+  uint16_t _logicalPages;
+  uint8_t  _pageSize;
+  uint8_t  _payload;
+  uint16_t _head;           // next physical page to consider
+  uint32_t _seq;            // of the last written page
+  uint8_t  _staticInterval = 8;
+  uint8_t  _writes;
+  uint32_t _relocations;
+
+  bool     _isUsed(const uint16_t index)  { return _used[index >> 3] & (1 << (index & 7)); };
+  void     _setUsed(const uint16_t index, const bool used);
+  uint16_t _pageAddress(const uint16_t index) { return (_firstPage + index) * _pageSize; };
+  uint16_t _nextFree(uint16_t &cold);
+  int      _writePage(const uint16_t logical, uint8_t *page, uint16_t &cold);
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint8_t length);
+};
+
+// -- END OF FILE --
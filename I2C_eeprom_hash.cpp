@@ -0,0 +1,305 @@
+//
+//    FILE: I2C_eeprom_hash.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Persistent hash table of fixed size records for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// bucket  one page of { key, value } * slots, the rest of the page is unused
+// key     I2C_EEPROM_HASH_EMPTY   slot never used since format() or rehash()
+//         I2C_EEPROM_HASH_DELETED slot of a removed record
+//
+// A lookup stops at the first bucket with an empty slot. A record is only
+// placed after its home bucket if all buckets in between have no free
+// slot, so a bucket with an empty slot is never passed by another record.
+
+
+#include <I2C_eeprom_hash.h>
+
+#define I2C_EEPROM_HASH_NONE  0xFFFFFFFFUL   // no free slot
+
+
+bool I2C_eeprom_hash::begin(I2C_eeprom &eeprom, const uint16_t firstPage, const uint16_t buckets, const uint8_t valueSize)
+{
+  _eeprom     = NULL;
+  _pageSize   = eeprom.getPageSize();
+  _recordSize = sizeof(uint32_t) + valueSize;
+  _slots      = (valueSize > _pageSize) ? 0 : _pageSize / _recordSize;
+  if ((_slots == 0) || (buckets == 0)) return false;
+
+  _eeprom     = &eeprom;
+  _firstPage  = firstPage;
+  _buckets    = buckets;
+  _valueSize  = valueSize;
+  _deleted    = 0;
+  _threshold  = getCapacity() / 8;
+  _probes     = 0;
+  return true;
+}
+
+bool I2C_eeprom_hash::format()
+{
+  if (_eeprom == NULL) return false;
+  _deleted = 0;
+  return _eeprom->erase(_firstPage * _pageSize, (uint32_t)_buckets * _pageSize, 0xFF) == 0;
+}
+
+bool I2C_eeprom_hash::get(const uint32_t key, void *value)
+{
+  if ((_eeprom == NULL) || (key >= I2C_EEPROM_HASH_DELETED)) return false;
+
+  uint8_t  page[_pageSize];
+  uint16_t bucket;
+  uint8_t  slot;
+  uint32_t free;
+  if (_find(key, page, bucket, slot, free) != 1) return false;
+  memcpy(value, page + slot * _recordSize + sizeof(uint32_t), _valueSize);
+  return true;
+}
+
+bool I2C_eeprom_hash::contains(const uint32_t key)
+{
+  if ((_eeprom == NULL) || (key >= I2C_EEPROM_HASH_DELETED)) return false;
+
+  uint8_t  page[_pageSize];
+  uint16_t bucket;
+  uint8_t  slot;
+  uint32_t free;
+  return _find(key, page, bucket, slot, free) == 1;
+}
+
+int I2C_eeprom_hash::put(const uint32_t key, const void *value)
+{
+  if ((_eeprom == NULL) || (key >= I2C_EEPROM_HASH_DELETED)) return -1;
+
+  uint8_t  page[_pageSize];
+  uint16_t bucket;
+  uint8_t  slot;
+  uint32_t free;
+  int rv = _find(key, page, bucket, slot, free);
+  if (rv < 0) return -1;
+  if (rv == 1)
+  {
+    // replace the value only if it changed
+    uint8_t * current = page + slot * _recordSize + sizeof(uint32_t);
+    if (memcmp(current, value, _valueSize) == 0) return 0;
+    return _eeprom->writeBlock(_address(bucket, slot) + sizeof(uint32_t), (const uint8_t *)value, _valueSize);
+  }
+  if (free == I2C_EEPROM_HASH_NONE) return -1;
+
+  // the first free slot on the way, key and value in one write
+  bucket = free / _slots;
+  slot   = free % _slots;
+  bool reused = _freeDeleted;
+  uint8_t record[_recordSize];
+  memcpy(record, &key, sizeof(uint32_t));
+  memcpy(record + sizeof(uint32_t), value, _valueSize);
+  rv = _eeprom->writeBlock(_address(bucket, slot), record, _recordSize);
+  if ((rv == 0) && reused && (_deleted > 0)) _deleted--;
+  return rv;
+}
+
+bool I2C_eeprom_hash::remove(const uint32_t key)
+{
+  if ((_eeprom == NULL) || (key >= I2C_EEPROM_HASH_DELETED)) return false;
+
+  uint8_t  page[_pageSize];
+  uint16_t bucket;
+  uint8_t  slot;
+  uint32_t free;
+  bool     removed = false;
+  // repeat, a reset during rehash() can leave a second copy
+  while (_find(key, page, bucket, slot, free) == 1)
+  {
+    // no record passes a bucket with an empty slot, so the
+    // slot can be empty as well instead of deleted.
+    bool chainEnd = false;
+    for (uint8_t s = 0; s < _slots; s++)
+    {
+      if (_key(page, s) == I2C_EEPROM_HASH_EMPTY) chainEnd = true;
+    }
+    if (_writeKey(bucket, slot, chainEnd ? I2C_EEPROM_HASH_EMPTY : I2C_EEPROM_HASH_DELETED) != 0) return removed;
+    if (!chainEnd) _deleted++;
+    removed = true;
+  }
+  if (removed && (_threshold > 0) && (_deleted >= _threshold)) rehash();
+  return removed;
+}
+
+// 1. every record moves to the first free slot between its home bucket
+//    and its bucket, if there is one. The new copy is written first and
+//    the old slot becomes deleted, so no slot becomes empty in this step.
+// 2. every deleted slot becomes empty, one write per bucket. After 1 no
+//    record passes a bucket with a free slot, so no lookup is cut short.
+// A reset at any point leaves a table without broken chains, at worst
+// with a record twice until the next rehash().
+int I2C_eeprom_hash::rehash()
+{
+  if (_eeprom == NULL) return -1;
+
+  uint8_t  page[_pageSize];
+  uint8_t  other[_pageSize];
+  uint16_t size    = _slots * _recordSize;
+  uint32_t deleted = I2C_EEPROM_HASH_DELETED;
+
+  // a move frees a slot that can be on the way of a record handled
+  // before, so repeat until nothing moves, every pass moves records closer.
+  bool moved = true;
+  while (moved)
+  {
+    moved = false;
+    for (uint16_t b = 0; b < _buckets; b++)
+    {
+      if (!_readBucket(b, page)) return -1;
+      for (uint8_t s = 0; s < _slots; s++)
+      {
+        uint32_t k = _key(page, s);
+        if (k >= I2C_EEPROM_HASH_DELETED) continue;
+
+        for (uint16_t c = _home(k); c != b; c = (c + 1) % _buckets)
+        {
+          if (!_readBucket(c, other)) return -1;
+          uint8_t t      = _slots;
+          bool    copied = false;
+          for (uint8_t u = 0; u < _slots; u++)
+          {
+            uint32_t key = _key(other, u);
+            if (key == k) copied = true;
+            if ((key >= I2C_EEPROM_HASH_DELETED) && (t == _slots)) t = u;
+          }
+          if (!copied && (t == _slots)) continue;
+
+          // new copy first, a reset in between leaves two copies.
+          // A lookup finds the first one, the second one is removed here.
+          if (!copied)
+          {
+            int rv = _eeprom->writeBlock(_address(c, t), page + s * _recordSize, _recordSize);
+            if (rv != 0) return rv;
+          }
+          int rv = _writeKey(b, s, I2C_EEPROM_HASH_DELETED);
+          if (rv != 0) return rv;
+          memcpy(page + s * _recordSize, &deleted, sizeof(uint32_t));
+          moved = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (uint16_t b = 0; b < _buckets; b++)
+  {
+    if (!_readBucket(b, page)) return -1;
+    bool changed = false;
+    for (uint8_t s = 0; s < _slots; s++)
+    {
+      if (_key(page, s) == I2C_EEPROM_HASH_DELETED)
+      {
+        memset(page + s * _recordSize, 0xFF, sizeof(uint32_t));
+        changed = true;
+      }
+    }
+    if (changed)
+    {
+      int rv = _eeprom->writeBlock(_address(b, 0), page, size);
+      if (rv != 0) return rv;
+    }
+  }
+  _deleted = 0;
+  return 0;
+}
+
+uint16_t I2C_eeprom_hash::count()
+{
+  if (_eeprom == NULL) return 0;
+
+  uint8_t  page[_pageSize];
+  uint16_t cnt = 0;
+  uint16_t deleted = 0;
+  for (uint16_t b = 0; b < _buckets; b++)
+  {
+    if (!_readBucket(b, page)) continue;
+    for (uint8_t s = 0; s < _slots; s++)
+    {
+      uint32_t k = _key(page, s);
+      if (k == I2C_EEPROM_HASH_DELETED) deleted++;
+      else if (k != I2C_EEPROM_HASH_EMPTY) cnt++;
+    }
+  }
+  _deleted = deleted;
+  return cnt;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// Fibonacci hashing, the upper bits are mixed best
+uint16_t I2C_eeprom_hash::_home(const uint32_t key)
+{
+  uint32_t h = key * 2654435761UL;
+  return (h >> 16) % _buckets;
+}
+
+uint16_t I2C_eeprom_hash::_address(const uint16_t bucket, const uint8_t slot)
+{
+  return (_firstPage + bucket) * _pageSize + slot * _recordSize;
+}
+
+uint32_t I2C_eeprom_hash::_key(const uint8_t *page, const uint8_t slot)
+{
+  uint32_t key;
+  memcpy(&key, page + slot * _recordSize, sizeof(key));
+  return key;
+}
+
+bool I2C_eeprom_hash::_readBucket(const uint16_t bucket, uint8_t *page)
+{
+  uint16_t size = _slots * _recordSize;
+  return _eeprom->readBlock(_address(bucket, 0), page, size) == size;
+}
+
+int I2C_eeprom_hash::_writeKey(const uint16_t bucket, const uint8_t slot, const uint32_t key)
+{
+  return _eeprom->writeBlock(_address(bucket, slot), (const uint8_t *)&key, sizeof(key));
+}
+
+// returns 1 if found, page holds its bucket. 0 if not found, free is the
+// first free slot on the way as bucket * slots + slot. -1 on a read error.
+int I2C_eeprom_hash::_find(const uint32_t key, uint8_t *page, uint16_t &bucket, uint8_t &slot, uint32_t &free)
+{
+  free    = I2C_EEPROM_HASH_NONE;
+  _probes = 0;
+  uint16_t b = _home(key);
+  for (uint16_t i = 0; i < _buckets; i++)
+  {
+    if (!_readBucket(b, page)) return -1;
+    _probes++;
+    bool chainEnd = false;
+    for (uint8_t s = 0; s < _slots; s++)
+    {
+      uint32_t k = _key(page, s);
+      if (k == key)
+      {
+        bucket = b;
+        slot   = s;
+        return 1;
+      }
+      if (k == I2C_EEPROM_HASH_EMPTY) chainEnd = true;
+      if (((k == I2C_EEPROM_HASH_EMPTY) || (k == I2C_EEPROM_HASH_DELETED)) && (free == I2C_EEPROM_HASH_NONE))
+      {
+        free = (uint32_t)b * _slots + s;
+        _freeDeleted = (k == I2C_EEPROM_HASH_DELETED);
+      }
+    }
+    if (chainEnd) return 0;
+    b = (b + 1 == _buckets) ? 0 : b + 1;
+  }
+  return 0;
+}
+
+// -- END OF FILE --
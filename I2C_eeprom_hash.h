@@ -0,0 +1,86 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_hash.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Persistent hash table of fixed size records for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// reserved keys, a slot that is erased / deleted
+#define I2C_EEPROM_HASH_EMPTY     0xFFFFFFFFUL
+#define I2C_EEPROM_HASH_DELETED   0xFFFFFFFEUL
+
+class I2C_eeprom_hash
+{
+public:
+  /**
+    * Open addressing hash table of { key, value } records in a region
+    * of the EEPROM, nothing of it is kept in RAM.
+    *
+    * Every page is a bucket of getPageSize() / (4 + valueSize) slots.
+    * A key is looked up in its home bucket and, if that bucket is full,
+    * in the next ones, so a lookup is one read of one page as long as
+    * the table is not too full. A put() or remove() writes one slot.
+    *
+    * @param eeprom    The instance of I2C_eeprom to use.
+    * @param firstPage First page of the region.
+    * @param buckets   Number of pages of the region.
+    * @param valueSize Bytes of the value of a record.
+    * @return True if at least one slot fits in a page, false otherwise.
+    */
+  bool     begin(I2C_eeprom &eeprom, const uint16_t firstPage, const uint16_t buckets, const uint8_t valueSize);
+
+  // erases all records, only pages that are not empty are written.
+  bool     format();
+
+  // reads the value of key, returns false if not found.
+  bool     get(const uint32_t key, void *value);
+  bool     contains(const uint32_t key);
+  // adds or replaces the record of key.
+  // return 0 if OK, -1 if the table is full or key is reserved, error code otherwise.
+  int      put(const uint32_t key, const void *value);
+  // removes the record of key, returns false if not found.
+  bool     remove(const uint32_t key);
+
+  // deleted slots make lookups of missing keys read more pages, rehash()
+  // frees them and moves records closer to their home bucket.
+  // Also done by remove() after threshold deletes, 0 = off,
+  // default 1/8 of the capacity. return 0 if OK, error code otherwise.
+  int      rehash();
+  void     setRehashThreshold(const uint16_t threshold) { _threshold = threshold; };
+  uint16_t getRehashThreshold() { return _threshold; };
+  // deleted slots since begin(), or as found by count().
+  uint16_t getDeleted()   { return _deleted; };
+
+  // reads the whole region, returns the number of records.
+  uint16_t count();
+  uint16_t getCapacity()  { return _buckets * _slots; };
+  uint16_t getBuckets()   { return _buckets; };
+  uint8_t  getSlots()     { return _slots; };
+  // pages read by the last lookup, for diagnostics.
+  uint16_t getProbes()    { return _probes; };
+
+private:
+  I2C_eeprom * _eeprom = NULL;
+  uint16_t _firstPage;
+  uint16_t _buckets;
+  uint8_t  _pageSize;
+  uint8_t  _valueSize;
+  uint8_t  _recordSize;
+  uint8_t  _slots;
+  uint16_t _deleted;
+  uint16_t _threshold;
+  uint16_t _probes;
+  bool     _freeDeleted;   // free slot of the last _find() was deleted
+
+  uint16_t _home(const uint32_t key);
+  uint16_t _address(const uint16_t bucket, const uint8_t slot);
+  uint32_t _key(const uint8_t *page, const uint8_t slot);
+  bool     _readBucket(const uint16_t bucket, uint8_t *page);
+  int      _writeKey(const uint16_t bucket, const uint8_t slot, const uint32_t key);
+  int      _find(const uint32_t key, uint8_t *page, uint16_t &bucket, uint8_t &slot, uint32_t &free);
+};
+
+// -- END OF FILE --
@@ -0,0 +1,211 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_layout.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Compile time layout of regions for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+#include <I2C_eeprom_typed.h>
+#include <I2C_eeprom_cyclic_store.h>
+
+/**
+ * @brief Region of a single value, bound to an I2C_eeprom_var.
+ *
+ * @tparam T the type of the value.
+ * @tparam ALIGN alignment of the address in bytes, 0 = page (default).
+ */
+template <typename T, uint16_t ALIGN = 0>
+struct I2C_eeprom_var_region
+{
+    typedef I2C_eeprom_var<T> accessor;
+    static constexpr uint16_t align = ALIGN;
+    static constexpr uint16_t element = 0;     // no elements to keep within a page
+    static constexpr uint16_t slots = 0;
+
+    static constexpr uint32_t size(const uint8_t) { return sizeof(T); }
+    static accessor bind(I2C_eeprom &eeprom, const uint16_t address) { return accessor(eeprom, address); }
+};
+
+/**
+ * @brief Region of COUNT values, bound to an I2C_eeprom_array.
+ *
+ * An element may not straddle a page, so in an array larger than a
+ * page the page size must be a multiple of sizeof(T) or vice versa.
+ *
+ * @tparam T the type of the elements.
+ * @tparam COUNT the number of elements.
+ * @tparam ALIGN alignment of the address in bytes, 0 = page (default).
+ */
+template <typename T, uint16_t COUNT, uint16_t ALIGN = 0>
+struct I2C_eeprom_array_region
+{
+    static_assert(COUNT > 0, "I2C_eeprom_array_region: COUNT must be > 0");
+
+    typedef I2C_eeprom_array<T> accessor;
+    static constexpr uint16_t align = ALIGN;
+    static constexpr uint16_t element = sizeof(T);
+    static constexpr uint16_t slots = 0;
+
+    static constexpr uint32_t size(const uint8_t) { return (uint32_t)sizeof(T) * COUNT; }
+    static accessor bind(I2C_eeprom &eeprom, const uint16_t address) { return accessor(eeprom, address, COUNT); }
+};
+
+/**
+ * @brief Region of an I2C_eeprom_cyclic_store with SLOTS slots.
+ *
+ * A slot holds the version and a T, plus DELTA pages if delta mode is
+ * used. In that case call enableDelta(shadow, DELTA) before begin().
+ *
+ * @tparam T the type of the data structure of the store.
+ * @tparam SLOTS the number of slots the writes rotate over, at least 2.
+ * @tparam DELTA the number of delta pages per slot.
+ */
+template <typename T, uint16_t SLOTS, uint8_t DELTA = 0>
+struct I2C_eeprom_store_region
+{
+    static_assert(SLOTS >= 2, "I2C_eeprom_store_region: a store needs at least 2 slots");
+
+    typedef I2C_eeprom_cyclic_store<T> accessor;
+    static constexpr uint16_t align = 0;
+    static constexpr uint16_t element = 0;
+    static constexpr uint16_t slots = SLOTS;
+
+    static constexpr uint32_t size(const uint8_t pageSize)
+    {
+        return (uint32_t)SLOTS * ((sizeof(uint32_t) + sizeof(T) + pageSize - 1) / pageSize + DELTA) * pageSize;
+    }
+};
+
+
+/**
+ * @brief Places REGIONS... from OFFSET on, one level per region.
+ *
+ * A region starts at the next multiple of its alignment. A region that
+ * fits in a page but would straddle one, and every region larger than
+ * a page, starts at the next page instead.
+ */
+template <uint8_t PAGESIZE, uint32_t OFFSET, typename... REGIONS>
+struct _I2C_eeprom_place
+{
+    static constexpr uint32_t end = OFFSET;
+};
+
+template <uint8_t PAGESIZE, uint32_t OFFSET, typename R, typename... REST>
+struct _I2C_eeprom_place<PAGESIZE, OFFSET, R, REST...>
+{
+    typedef R region;
+    static constexpr uint32_t size    = R::size(PAGESIZE);
+    static constexpr uint32_t align   = (R::align == 0) ? PAGESIZE : R::align;
+    static constexpr uint32_t aligned = (OFFSET + align - 1) / align * align;
+    static constexpr bool     newPage = (size > PAGESIZE) || (aligned / PAGESIZE != (aligned + size - 1) / PAGESIZE);
+    static constexpr uint32_t offset  = newPage ? (aligned + PAGESIZE - 1) / PAGESIZE * PAGESIZE : aligned;
+
+    static_assert(size > 0, "I2C_eeprom_layout: empty region");
+    static_assert((R::element == 0) || (size <= PAGESIZE)
+                  || (PAGESIZE % R::element == 0) || (R::element % PAGESIZE == 0),
+                  "I2C_eeprom_layout: array elements straddle pages, pad the element type");
+
+    typedef _I2C_eeprom_place<PAGESIZE, offset + size, REST...> next;
+    static constexpr uint32_t end = next::end;
+};
+
+template <uint8_t I, typename PLACE>
+struct _I2C_eeprom_index
+{
+    typedef typename _I2C_eeprom_index<I - 1, typename PLACE::next>::type type;
+};
+
+template <typename PLACE>
+struct _I2C_eeprom_index<0, PLACE>
+{
+    typedef PLACE type;
+};
+
+
+/**
+ * @brief Assigns the addresses of a list of regions at compile time.
+ *
+ * Replaces a hand written table of offsets. The layout fails to compile
+ * if the regions do not fit in the device or if array elements would
+ * straddle a page, so a field never costs two write cycles by accident.
+ * Everything is computed by the compiler, the accessors are the same as
+ * when constructed with a literal address.
+ *
+ * Example:
+ * @code
+ * typedef I2C_eeprom_layout<I2C_DEVICESIZE_24LC256, 64,
+ *     I2C_eeprom_var_region<Config>,
+ *     I2C_eeprom_array_region<Sample, 100>,
+ *     I2C_eeprom_store_region<Counters, 8> > Layout;
+ * enum { CONFIG, SAMPLES, COUNTERS };
+ *
+ * auto config = Layout::get<CONFIG>(ee);
+ * Layout::begin<COUNTERS>(store, ee);
+ * @endcode
+ *
+ * @tparam DEVICESIZE the size of the device in bytes, max 65536.
+ * @tparam PAGESIZE the page size of the device, as I2C_eeprom::getPageSize().
+ * @tparam REGIONS the regions in the order they are placed.
+ */
+template <uint32_t DEVICESIZE, uint8_t PAGESIZE, typename... REGIONS>
+class I2C_eeprom_layout
+{
+    typedef _I2C_eeprom_place<PAGESIZE, 0, REGIONS...> _places;
+
+    template <uint8_t I>
+    struct _at
+    {
+        static_assert(I < sizeof...(REGIONS), "I2C_eeprom_layout: no such region");
+        typedef typename _I2C_eeprom_index<I, _places>::type type;
+    };
+
+    static_assert(PAGESIZE > 0, "I2C_eeprom_layout: page size must be > 0");
+    static_assert(DEVICESIZE <= 65536UL, "I2C_eeprom_layout: device too large for 16 bit addresses");
+    static_assert(_places::end <= DEVICESIZE, "I2C_eeprom_layout: the regions do not fit in the device");
+
+public:
+    static constexpr uint8_t  count()     { return sizeof...(REGIONS); }
+    // bytes up to the end of the last region, padding included.
+    static constexpr uint32_t used()      { return _places::end; }
+    static constexpr uint32_t available() { return DEVICESIZE - _places::end; }
+
+    template <uint8_t I>
+    static constexpr uint16_t address()   { return _at<I>::type::offset; }
+    template <uint8_t I>
+    static constexpr uint32_t size()      { return _at<I>::type::size; }
+    template <uint8_t I>
+    static constexpr uint16_t firstPage() { return _at<I>::type::offset / PAGESIZE; }
+    template <uint8_t I>
+    static constexpr uint16_t pages()     { return (_at<I>::type::size + PAGESIZE - 1) / PAGESIZE; }
+
+    /**
+      * @brief Returns the accessor of a var or array region.
+      */
+    template <uint8_t I>
+    static typename _at<I>::type::region::accessor get(I2C_eeprom &eeprom)
+    {
+        return _at<I>::type::region::bind(eeprom, address<I>());
+    }
+
+    /**
+      * @brief Calls begin() of a cyclic store with the pages of a store region.
+      */
+    template <uint8_t I, typename STORE, typename EEPROM>
+    static bool begin(STORE &store, EEPROM &eeprom)
+    {
+        static_assert(_at<I>::type::region::slots > 0, "I2C_eeprom_layout: not a store region");
+        return store.begin(eeprom, PAGESIZE, pages<I>(), firstPage<I>());
+    }
+
+    /**
+      * @brief Checks at runtime that the layout matches the eeprom.
+      */
+    static bool check(I2C_eeprom &eeprom)
+    {
+        return (eeprom.getPageSize() == PAGESIZE) && (eeprom.getDeviceSize() == DEVICESIZE);
+    }
+};
+
+// -- END OF FILE --
@@ -0,0 +1,188 @@
+//
+//    FILE: I2C_eeprom_partition.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: On device partition table for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// header  { magic "EEPT", seq, count, crc8 } * 2
+// entries { name[8], firstPage, pages } * I2C_EEPROM_PARTITIONS
+//
+// add() writes the new entry before the header. The crc of the header
+// covers only the first count entries, so a reset in between leaves the
+// previous table intact and the next add() overwrites the new entry.
+// The header has two copies, the older one is overwritten with the next
+// seq. A reset during that write gives a crc mismatch of that copy and
+// begin() uses the other one, the table before add().
+
+
+#include <I2C_eeprom_partition.h>
+
+#define I2C_EEPROM_PARTITION_MAGIC  0x54504545   // "EEPT"
+
+
+bool I2C_eeprom_partition_table::begin(I2C_eeprom &eeprom, const uint16_t firstPage)
+{
+  _eeprom     = &eeprom;
+  _firstPage  = firstPage;
+  _totalPages = eeprom.getDeviceSize() / eeprom.getPageSize();
+  _count      = 0;
+  _seq        = 0;
+  _copy       = 0;
+
+  uint16_t tableSize  = 2 * sizeof(header) + I2C_EEPROM_PARTITIONS * sizeof(entry);
+  uint8_t  pageSize   = eeprom.getPageSize();
+  _freePage = firstPage + (tableSize + pageSize - 1) / pageSize;
+
+  // the valid copy with the newest seq
+  header h[2];
+  uint16_t addr = _firstPage * pageSize;
+  if (_eeprom->readBlock(addr, (uint8_t *)h, sizeof(h)) != sizeof(h)) return false;
+  bool found = false;
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    if (h[i].magic != I2C_EEPROM_PARTITION_MAGIC) continue;
+    if (h[i].count > I2C_EEPROM_PARTITIONS) continue;
+    if (found && ((int16_t)(h[i].seq - _seq) <= 0)) continue;
+    if (h[i].crc != _crc(h[i].seq, h[i].count)) continue;
+    found  = true;
+    _copy  = i;
+    _seq   = h[i].seq;
+    _count = h[i].count;
+  }
+  if (!found) return false;
+
+  if (_count > 0)
+  {
+    entry e;
+    if (!_readEntry(_count - 1, e)) return false;
+    _freePage = e.firstPage + e.pages;
+  }
+  return true;
+}
+
+bool I2C_eeprom_partition_table::format()
+{
+  if (_eeprom == NULL) return false;
+  // both copies, so no older table remains
+  if (!_writeHeader(0) || !_writeHeader(0)) return false;
+  _count = 0;
+  uint16_t tableSize = 2 * sizeof(header) + I2C_EEPROM_PARTITIONS * sizeof(entry);
+  uint8_t  pageSize  = _eeprom->getPageSize();
+  _freePage = _firstPage + (tableSize + pageSize - 1) / pageSize;
+  return true;
+}
+
+bool I2C_eeprom_partition_table::add(const char *name, const uint16_t pages)
+{
+  if (_eeprom == NULL) return false;
+  if (_count >= I2C_EEPROM_PARTITIONS) return false;
+  if (pages == 0 || pages > getFreePages()) return false;
+
+  uint16_t fp, p;
+  if (find(name, fp, p)) return false;
+
+  entry e;
+  memset(&e, 0, sizeof(e));
+  strncpy(e.name, name, I2C_EEPROM_PARTITION_NAME);
+  e.firstPage = _freePage;
+  e.pages = pages;
+  if (_eeprom->writeBlock(_entryAddress(_count), (uint8_t *)&e, sizeof(e)) != 0) return false;
+  if (!_writeHeader(_count + 1)) return false;
+
+  _count++;
+  _freePage += pages;
+  return true;
+}
+
+bool I2C_eeprom_partition_table::find(const char *name, uint16_t &firstPage, uint16_t &pages)
+{
+  entry e;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (!_readEntry(i, e)) return false;
+    if (strncmp(e.name, name, I2C_EEPROM_PARTITION_NAME) == 0)
+    {
+      firstPage = e.firstPage;
+      pages = e.pages;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool I2C_eeprom_partition_table::get(const uint8_t index, char *name, uint16_t &firstPage, uint16_t &pages)
+{
+  entry e;
+  if (index >= _count) return false;
+  if (!_readEntry(index, e)) return false;
+  memcpy(name, e.name, I2C_EEPROM_PARTITION_NAME);
+  name[I2C_EEPROM_PARTITION_NAME] = 0;
+  firstPage = e.firstPage;
+  pages = e.pages;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+uint16_t I2C_eeprom_partition_table::_entryAddress(const uint8_t index)
+{
+  return _firstPage * _eeprom->getPageSize() + 2 * sizeof(header) + index * sizeof(entry);
+}
+
+bool I2C_eeprom_partition_table::_readEntry(const uint8_t index, entry &e)
+{
+  return _eeprom->readBlock(_entryAddress(index), (uint8_t *)&e, sizeof(e)) == sizeof(e);
+}
+
+// CRC-8 (poly 0x07) over seq, count and the first count entries
+uint8_t I2C_eeprom_partition_table::_crc(const uint16_t seq, const uint8_t count)
+{
+  entry   e;
+  uint8_t crc = _crc8(0, (const uint8_t *)&seq, sizeof(seq));
+  crc = _crc8(crc, &count, 1);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (!_readEntry(i, e)) return ~crc;   // unreadable => mismatch
+    crc = _crc8(crc, (uint8_t *)&e, sizeof(e));
+  }
+  return crc;
+}
+
+uint8_t I2C_eeprom_partition_table::_crc8(uint8_t crc, const uint8_t *data, const uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// overwrites the older copy with the next seq
+bool I2C_eeprom_partition_table::_writeHeader(const uint8_t count)
+{
+  header h;
+  memset(&h, 0, sizeof(h));
+  h.magic = I2C_EEPROM_PARTITION_MAGIC;
+  h.seq   = _seq + 1;
+  h.count = count;
+  h.crc   = _crc(h.seq, count);
+  uint8_t  copy = 1 - _copy;
+  uint16_t addr = _firstPage * _eeprom->getPageSize() + copy * sizeof(h);
+  if (_eeprom->writeBlock(addr, (uint8_t *)&h, sizeof(h)) != 0) return false;
+  _seq  = h.seq;
+  _copy = copy;
+  return true;
+}
+
+// -- END OF FILE --
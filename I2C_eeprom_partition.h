@@ -0,0 +1,83 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_partition.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: On device partition table for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// maximum number of partitions in a table
+#ifndef I2C_EEPROM_PARTITIONS
+#define I2C_EEPROM_PARTITIONS     8
+#endif
+
+// significant characters of a partition name
+#define I2C_EEPROM_PARTITION_NAME 8
+
+class I2C_eeprom_partition_table
+{
+public:
+  /**
+    * Loads the partition table stored at firstPage of the eeprom.
+    *
+    * The table itself uses the first pages, partitions are allocated
+    * in order directly after it.
+    *
+    * @param eeprom    The instance of I2C_eeprom to use.
+    * @param firstPage Page where the table is stored.
+    * @return True if a valid table was found, false otherwise (call format()).
+    */
+  bool     begin(I2C_eeprom &eeprom, const uint16_t firstPage = 0);
+
+  // writes an empty table, existing partitions are forgotten.
+  bool     format();
+
+  // allocates a partition of pages pages after the last one.
+  // fails if the name exists, the table is full or the device is full.
+  bool     add(const char *name, const uint16_t pages);
+
+  // looks up a partition by name.
+  bool     find(const char *name, uint16_t &firstPage, uint16_t &pages);
+  // looks up a partition by index, name must hold I2C_EEPROM_PARTITION_NAME + 1 chars.
+  bool     get(const uint8_t index, char *name, uint16_t &firstPage, uint16_t &pages);
+
+  uint8_t  count()        { return _count; };
+  // first page not used by the table or any partition.
+  uint16_t getFreePage()  { return _freePage; };
+  uint16_t getFreePages() { return _totalPages - _freePage; };
+  I2C_eeprom * getEEPROM() { return _eeprom; };
+
+private:
+  struct entry
+  {
+    char     name[I2C_EEPROM_PARTITION_NAME];
+    uint16_t firstPage;
+    uint16_t pages;
+  };
+
+  struct header
+  {
+    uint32_t magic;
+    uint16_t seq;       // of two copies the valid one with the newest seq is used
+    uint8_t  count;
+    uint8_t  crc;       // over seq, count and entries
+  };
+
+  I2C_eeprom * _eeprom = NULL;
+  uint16_t _firstPage;
+  uint16_t _totalPages;
+  uint16_t _freePage;
+  uint8_t  _count = 0;
+  uint16_t _seq   = 0;
+  uint8_t  _copy  = 0;    // header copy in use
+
+  uint16_t _entryAddress(const uint8_t index);
+  bool     _readEntry(const uint8_t index, entry &e);
+  uint8_t  _crc(const uint16_t seq, const uint8_t count);
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint8_t length);
+  bool     _writeHeader(const uint8_t count);
+};
+
+// -- END OF FILE --
@@ -0,0 +1,106 @@
+//
+//    FILE: I2C_eeprom_reader.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Stream with read-ahead buffer on top of I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+
+
+#include <I2C_eeprom_reader.h>
+
+
+I2C_eeprom_reader::I2C_eeprom_reader(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length)
+{
+  _eeprom      = &eeprom;
+  _start       = memoryAddress;
+  _end         = (uint32_t)memoryAddress + length;
+  _position    = memoryAddress;
+  _windowStart = memoryAddress;
+  _windowFill  = 0;
+  _windowSize  = I2C_EEPROM_READAHEAD;
+}
+
+int I2C_eeprom_reader::available()
+{
+  uint32_t rv = _end - _position;
+  if (rv > 0x7FFF) rv = 0x7FFF;   // int is 16 bit on AVR
+  return rv;
+}
+
+int I2C_eeprom_reader::read()
+{
+  int rv = peek();
+  if (rv >= 0) _position++;
+  return rv;
+}
+
+int I2C_eeprom_reader::peek()
+{
+  if (_position >= _end) return -1;
+  if (!_inWindow() && !_fill()) return -1;
+  return _window[_position - _windowStart];
+}
+
+size_t I2C_eeprom_reader::write(uint8_t value)
+{
+  (void) value;
+  return 0;
+}
+
+uint16_t I2C_eeprom_reader::read(uint8_t* buffer, const uint16_t length)
+{
+  uint16_t len = length;
+  if (len > _end - _position) len = _end - _position;
+
+  uint16_t cnt = 0;
+  // first drain what is already fetched
+  while (cnt < len && _inWindow())
+  {
+    buffer[cnt++] = _window[_position++ - _windowStart];
+  }
+  if (cnt < len)
+  {
+    uint16_t rv = _eeprom->readBlock(_position, buffer + cnt, len - cnt);
+    _position += rv;
+    cnt += rv;
+  }
+  return cnt;
+}
+
+bool I2C_eeprom_reader::seek(const uint16_t memoryAddress)
+{
+  if (memoryAddress < _start || memoryAddress > _end) return false;
+  _position = memoryAddress;
+  return true;
+}
+
+void I2C_eeprom_reader::setWindow(const uint8_t size)
+{
+  _windowSize = size;
+  if (_windowSize == 0) _windowSize = 1;
+  if (_windowSize > I2C_EEPROM_READAHEAD) _windowSize = I2C_EEPROM_READAHEAD;
+  _windowFill = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+bool I2C_eeprom_reader::_inWindow()
+{
+  return (_position >= _windowStart) && (_position - _windowStart < _windowFill);
+}
+
+bool I2C_eeprom_reader::_fill()
+{
+  uint8_t cnt = _windowSize;
+  if (cnt > _end - _position) cnt = _end - _position;
+  _windowStart = _position;
+  _windowFill  = _eeprom->readBlock(_position, _window, cnt);
+  return _windowFill > 0;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,65 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_reader.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Stream with read-ahead buffer on top of I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// Maximum size of the read-ahead window.
+// Defaults to the TWI buffer so every refill is a single bus read.
+#ifndef I2C_EEPROM_READAHEAD
+#define I2C_EEPROM_READAHEAD I2C_TWIBUFFERSIZE
+#endif
+
+class I2C_eeprom_reader : public Stream
+{
+public:
+  /**
+    * Stream over a region of the EEPROM.
+    *
+    * @param eeprom        The instance of I2C_eeprom to read from.
+    * @param memoryAddress Address of the first byte of the region.
+    * @param length        Number of bytes in the region.
+    */
+  I2C_eeprom_reader(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length);
+
+  // Stream interface
+  int      available();
+  int      read();
+  int      peek();
+  // reading only, write() always fails.
+  size_t   write(uint8_t value);
+
+  // reads length bytes into buffer, empties the window first
+  // and reads the remainder with a single readBlock().
+  // returns bytes read
+  uint16_t read(uint8_t* buffer, const uint16_t length);
+
+  // moves to an absolute address within the region.
+  // returns false if the address is outside the region.
+  bool     seek(const uint16_t memoryAddress);
+  uint32_t position() { return _position; };
+
+  // number of bytes fetched per refill, 1..I2C_EEPROM_READAHEAD
+  // smaller windows waste less bus time on short random reads.
+  void     setWindow(const uint8_t size);
+  uint8_t  getWindow() { return _windowSize; };
+
+private:
+  I2C_eeprom * _eeprom;
+  uint16_t _start;
+  uint32_t _end;           // one past last byte of region, 0x10000 at the top of a 64 KB device
+  uint32_t _position;      // next byte to return
+  uint32_t _windowStart;   // address of _window[0]
+  uint8_t  _windowFill;    // valid bytes in _window
+  uint8_t  _windowSize;
+  uint8_t  _window[I2C_EEPROM_READAHEAD];
+
+  bool     _inWindow();
+  bool     _fill();
+};
+
+// -- END OF FILE --
@@ -0,0 +1,265 @@
+//
+//    FILE: I2C_eeprom_remap.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Bad page detection and spare page remapping for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// header  { magic "EEBP", count, crc8 }
+// entries { page } * I2C_EEPROM_SPARES, entry i is moved to spare i
+// spares  follow the pages of the table
+//
+// A page is copied to its spare before the entry and the header are
+// written, a reset in between leaves the previous table intact.
+
+
+#include <I2C_eeprom_remap.h>
+
+#define I2C_EEPROM_REMAP_MAGIC  0x50424545   // "EEBP"
+
+
+bool I2C_eeprom_remap::begin(I2C_eeprom &eeprom, uint8_t *bad, const uint16_t firstPage, const uint8_t spares)
+{
+  _eeprom     = NULL;
+  _count      = 0;
+  if (bad == NULL) return false;
+
+  _eeprom     = &eeprom;
+  _bad        = bad;
+  _firstPage  = firstPage;
+  _pageSize   = eeprom.getPageSize();
+  _pages      = eeprom.getDeviceSize() / _pageSize;
+  _spares     = (spares > I2C_EEPROM_SPARES) ? I2C_EEPROM_SPARES : spares;
+
+  uint16_t tableSize = sizeof(header) + I2C_EEPROM_SPARES * sizeof(uint16_t);
+  _spareFirst = firstPage + (tableSize + _pageSize - 1) / _pageSize;
+  memset(_bad, 0, (_pages + 7) / 8);
+
+  header h;
+  uint16_t addr = _firstPage * _pageSize;
+  if (_eeprom->readBlock(addr, (uint8_t *)&h, sizeof(h)) != sizeof(h)) return false;
+  if (h.magic != I2C_EEPROM_REMAP_MAGIC) return false;
+  if (h.count > _spares) return false;
+  uint16_t size = h.count * sizeof(uint16_t);
+  if (_eeprom->readBlock(addr + sizeof(h), (uint8_t *)_entries, size) != size) return false;
+  if (h.crc != _crc(h.count)) return false;
+
+  _count = h.count;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    uint16_t page = _entries[i];
+    if (page < _pages) _bad[page >> 3] |= (1 << (page & 7));
+  }
+  return true;
+}
+
+bool I2C_eeprom_remap::format()
+{
+  if (_eeprom == NULL) return false;
+  if (_writeHeader(0) != 0) return false;
+  _count = 0;
+  memset(_bad, 0, (_pages + 7) / 8);
+  return true;
+}
+
+int I2C_eeprom_remap::writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return -1;
+
+  uint16_t addr = memoryAddress;
+  uint16_t len  = length;
+  while (len > 0)
+  {
+    uint8_t offset = addr % _pageSize;
+    uint8_t cnt = _pageSize - offset;
+    if (cnt > len) cnt = len;
+
+    int rv = _writePage(addr / _pageSize, offset, buffer, cnt);
+    if (rv != 0) return rv;
+
+    addr   += cnt;
+    buffer += cnt;
+    len    -= cnt;
+  }
+  return 0;
+}
+
+uint16_t I2C_eeprom_remap::readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return 0;
+
+  uint16_t addr = memoryAddress;
+  uint16_t len  = length;
+  uint16_t rv   = 0;
+  while (len > 0)
+  {
+    uint8_t offset = addr % _pageSize;
+    uint8_t cnt = _pageSize - offset;
+    if (cnt > len) cnt = len;
+
+    uint16_t physical = getPhysicalPage(addr / _pageSize) * _pageSize + offset;
+    uint16_t n = _eeprom->readBlock(physical, buffer, cnt);
+    rv += n;
+    if (n != cnt) return rv;
+
+    addr   += cnt;
+    buffer += cnt;
+    len    -= cnt;
+  }
+  return rv;
+}
+
+int I2C_eeprom_remap::updateBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return -1;
+
+  uint16_t addr = memoryAddress;
+  uint16_t len  = length;
+  uint8_t  current[_pageSize];
+  while (len > 0)
+  {
+    uint8_t offset = addr % _pageSize;
+    uint8_t cnt = _pageSize - offset;
+    if (cnt > len) cnt = len;
+
+    if ((readBlock(addr, current, cnt) != cnt) || (memcmp(current, buffer, cnt) != 0))
+    {
+      int rv = _writePage(addr / _pageSize, offset, buffer, cnt);
+      if (rv != 0) return rv;
+    }
+
+    addr   += cnt;
+    buffer += cnt;
+    len    -= cnt;
+  }
+  return 0;
+}
+
+int I2C_eeprom_remap::erase(const uint16_t memoryAddress, const uint32_t length, const uint8_t value)
+{
+  if (_eeprom == NULL) return -1;
+
+  uint8_t  fill[_pageSize];
+  memset(fill, value, _pageSize);
+
+  uint16_t addr = memoryAddress;
+  uint32_t len  = length;
+  while (len > 0)
+  {
+    uint8_t cnt = _pageSize - addr % _pageSize;
+    if (cnt > len) cnt = len;
+
+    int rv = updateBlock(addr, fill, cnt);
+    if (rv != 0) return rv;
+
+    addr += cnt;
+    len  -= cnt;
+  }
+  return 0;
+}
+
+bool I2C_eeprom_remap::retire(const uint16_t memoryAddress)
+{
+  if (_eeprom == NULL) return false;
+  return _retire(memoryAddress / _pageSize, 0, NULL, 0) == 0;
+}
+
+uint16_t I2C_eeprom_remap::getPhysicalPage(const uint16_t page)
+{
+  if (!isBad(page)) return page;
+  // the last entry wins, a spare can go bad as well
+  for (uint8_t i = _count; i > 0; i--)
+  {
+    if (_entries[i - 1] == page) return _spareFirst + i - 1;
+  }
+  return page;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+int I2C_eeprom_remap::_writePage(const uint16_t page, const uint8_t offset, const uint8_t *buffer, const uint8_t length)
+{
+  uint16_t addr = getPhysicalPage(page) * _pageSize + offset;
+  int rv = _eeprom->writeBlock(addr, buffer, length);
+  if (rv != 0) return rv;   // bus error, not a bad page
+  if (!_verify || _check(addr, buffer, length)) return 0;
+  return _retire(page, offset, buffer, length);
+}
+
+// moves page to the next spare with buffer written at offset.
+int I2C_eeprom_remap::_retire(const uint16_t page, const uint8_t offset, const uint8_t *buffer, const uint8_t length)
+{
+  if (page >= _pages) return -1;
+
+  uint8_t data[_pageSize];
+  memset(data, 0xFF, _pageSize);
+  _eeprom->readBlock(getPhysicalPage(page) * _pageSize, data, _pageSize);
+  if (buffer != NULL) memcpy(data + offset, buffer, length);
+
+  while (_count < _spares)
+  {
+    uint16_t spare = (_spareFirst + _count) * _pageSize;
+    int rv = _eeprom->writeBlock(spare, data, _pageSize);
+    if (rv != 0) return rv;
+    bool good = _check(spare, data, _pageSize);
+
+    // a failing spare is entered as well, so it is not used again
+    uint16_t entry = _firstPage * _pageSize + sizeof(header) + _count * sizeof(uint16_t);
+    rv = _eeprom->writeBlock(entry, (const uint8_t *)&page, sizeof(page));
+    if (rv != 0) return rv;
+    _entries[_count] = page;
+    rv = _writeHeader(_count + 1);
+    if (rv != 0) return rv;
+
+    _count++;
+    _bad[page >> 3] |= (1 << (page & 7));
+    if (good) return 0;
+  }
+  return -1;
+}
+
+bool I2C_eeprom_remap::_check(const uint16_t memoryAddress, const uint8_t *buffer, const uint8_t length)
+{
+  uint8_t current[length];
+  if (_eeprom->readBlock(memoryAddress, current, length) != length) return false;
+  return memcmp(current, buffer, length) == 0;
+}
+
+int I2C_eeprom_remap::_writeHeader(const uint8_t count)
+{
+  header h;
+  memset(&h, 0, sizeof(h));
+  h.magic = I2C_EEPROM_REMAP_MAGIC;
+  h.count = count;
+  h.crc   = _crc(count);
+  return _eeprom->writeBlock(_firstPage * _pageSize, (uint8_t *)&h, sizeof(h));
+}
+
+// CRC-8 (poly 0x07) over count and the first count entries
+uint8_t I2C_eeprom_remap::_crc(const uint8_t count)
+{
+  uint8_t crc = _crc8(0, &count, 1);
+  return _crc8(crc, (uint8_t *)_entries, count * sizeof(uint16_t));
+}
+
+uint8_t I2C_eeprom_remap::_crc8(uint8_t crc, const uint8_t *data, const uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,97 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_remap.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Bad page detection and spare page remapping for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// maximum number of spare pages
+#ifndef I2C_EEPROM_SPARES
+#define I2C_EEPROM_SPARES  8
+#endif
+
+class I2C_eeprom_remap
+{
+public:
+  /**
+    * Loads the bad page table stored at firstPage of the eeprom.
+    *
+    * The table uses the first pages, the spare pages follow directly
+    * after it. Pages that fail write verification, or are retired
+    * with retire(), are moved to the next spare page and all further
+    * access to the page goes to the spare.
+    *
+    * The interface matches I2C_eeprom for reading and writing, so it
+    * can be used as the EEPROM parameter of I2C_eeprom_cyclic_store.
+    *
+    * @param eeprom    The instance of I2C_eeprom to use.
+    * @param bad       Buffer of the caller of one bit per page of the device,
+    *                  i.e. (getDeviceSize() / getPageSize() + 7) / 8 bytes.
+    * @param firstPage Page where the table is stored.
+    * @param spares    Number of spare pages, max I2C_EEPROM_SPARES.
+    * @return True if a valid table was found, false otherwise (call format()).
+    */
+  bool     begin(I2C_eeprom &eeprom, uint8_t *bad, const uint16_t firstPage, const uint8_t spares);
+
+  // writes an empty table, existing remaps are forgotten.
+  bool     format();
+
+  // writes length bytes, with verify every page chunk is read back.
+  // return 0 if OK, -1 if a page failed and no spare is left, error code otherwise.
+  int      writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length);
+  // reads length bytes into buffer, returns bytes read
+  uint16_t readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length);
+  // writes only the page chunks that changed, return as writeBlock().
+  int      updateBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length);
+  // fills length bytes with value, return as writeBlock().
+  int      erase(const uint16_t memoryAddress, const uint32_t length, const uint8_t value = 0xFF);
+
+  // moves the page of memoryAddress to a spare, e.g. after a CRC error.
+  // the current content is copied as far as it can be read.
+  bool     retire(const uint16_t memoryAddress);
+
+  // read back every write, default true.
+  void     setVerify(const bool verify) { _verify = verify; };
+  bool     getVerify()      { return _verify; };
+
+  bool     isBad(const uint16_t page) { return page < _pages && (_bad[page >> 3] & (1 << (page & 7))); };
+  // page holding the data of page.
+  uint16_t getPhysicalPage(const uint16_t page);
+  uint8_t  count()          { return _count; };
+  uint8_t  getFreeSpares()  { return _spares - _count; };
+  // first page not used by the table or the spares.
+  uint16_t getFreePage()    { return _spareFirst + _spares; };
+  uint8_t  getPageSize()    { return _pageSize; };
+  uint32_t getDeviceSize()  { return _eeprom ? _eeprom->getDeviceSize() : 0; };
+
+private:
+  struct header
+  {
+    uint32_t magic;
+    uint8_t  count;
+    uint8_t  crc;       // over count and entries
+  };
+
+  I2C_eeprom * _eeprom = NULL;
+  uint8_t  * _bad;
+  uint16_t _firstPage;
+  uint16_t _spareFirst;
+  uint16_t _pages;
+  uint8_t  _pageSize;
+  uint8_t  _spares;
+  uint8_t  _count = 0;
+  bool     _verify = true;
+  uint16_t _entries[I2C_EEPROM_SPARES];   // entry i is moved to spare i
+
+  int      _writePage(const uint16_t page, const uint8_t offset, const uint8_t *buffer, const uint8_t length);
+  int      _retire(const uint16_t page, const uint8_t offset, const uint8_t *buffer, const uint8_t length);
+  bool     _check(const uint16_t memoryAddress, const uint8_t *buffer, const uint8_t length);
+  int      _writeHeader(const uint8_t count);
+  uint8_t  _crc(const uint8_t count);
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint8_t length);
+};
+
+// -- END OF FILE --
@@ -0,0 +1,189 @@
+//
+//    FILE: I2C_eeprom_scheduler.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Write coalescing on top of I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// Cache page i is cache[i * pageSize], its slot holds the page and the
+// queued range first..last. The range is kept contiguous, bytes in
+// between two writes are read from the eeprom before they are merged.
+
+
+#include <I2C_eeprom_scheduler.h>
+
+
+bool I2C_eeprom_scheduler::begin(I2C_eeprom &eeprom, uint8_t *cache, const uint8_t pages)
+{
+  _eeprom = NULL;
+  if ((cache == NULL) || (pages == 0)) return false;
+
+  _eeprom   = &eeprom;
+  _cache    = cache;
+  _pages    = (pages > I2C_EEPROM_SCHEDULER_PAGES) ? I2C_EEPROM_SCHEDULER_PAGES : pages;
+  _pageSize = eeprom.getPageSize();
+  _since    = 0;
+  _programs = 0;
+  for (uint8_t i = 0; i < _pages; i++) _slots[i].used = false;
+  return true;
+}
+
+int I2C_eeprom_scheduler::writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return -1;
+
+  uint16_t addr = memoryAddress;
+  uint16_t len  = length;
+  while (len > 0)
+  {
+    uint16_t page   = addr / _pageSize;
+    uint8_t  offset = addr % _pageSize;
+    uint8_t  cnt    = _pageSize - offset;
+    if (cnt > len) cnt = len;
+    uint8_t  last   = offset + cnt - 1;
+
+    int index = _slotOf(page);
+    if (index < 0)
+    {
+      // cache full => program all pages
+      int rv = flush();
+      if (rv != 0) return rv;
+      index = _slotOf(page);
+    }
+    slot &s = _slots[index];
+    uint8_t * data = _cache + index * _pageSize;
+    uint16_t start = page * _pageSize;
+
+    if (s.used)
+    {
+      // read the gap between the queued range and the new one
+      bool ok = true;
+      if (offset > s.last + 1)
+      {
+        uint8_t n = offset - s.last - 1;
+        ok = (_eeprom->readBlock(start + s.last + 1, data + s.last + 1, n) == n);
+      }
+      else if (last + 1 < s.first)
+      {
+        uint8_t n = s.first - last - 1;
+        ok = (_eeprom->readBlock(start + last + 1, data + last + 1, n) == n);
+      }
+      if (ok)
+      {
+        if (offset < s.first) s.first = offset;
+        if (last > s.last) s.last = last;
+      }
+      else
+      {
+        // program the queued range and start a new one
+        int rv = _program(index);
+        if (rv != 0) return rv;
+      }
+    }
+    if (!s.used)
+    {
+      if (pending() == 0) _since = millis();
+      s.used  = true;
+      s.page  = page;
+      s.first = offset;
+      s.last  = last;
+    }
+    memcpy(data + offset, buffer, cnt);
+
+    addr   += cnt;
+    buffer += cnt;
+    len    -= cnt;
+  }
+  return 0;
+}
+
+uint16_t I2C_eeprom_scheduler::readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length)
+{
+  if (_eeprom == NULL) return 0;
+
+  uint16_t rv = _eeprom->readBlock(memoryAddress, buffer, length);
+  uint32_t end = (uint32_t)memoryAddress + rv;
+  for (uint8_t i = 0; i < _pages; i++)
+  {
+    slot &s = _slots[i];
+    if (!s.used) continue;
+    uint32_t first = (uint32_t)s.page * _pageSize + s.first;
+    uint32_t last  = (uint32_t)s.page * _pageSize + s.last + 1;
+    if (first < memoryAddress) first = memoryAddress;
+    if (last > end) last = end;
+    if (first >= last) continue;
+    memcpy(buffer + (first - memoryAddress), _cache + i * _pageSize + first % _pageSize, last - first);
+  }
+  return rv;
+}
+
+int I2C_eeprom_scheduler::poll()
+{
+  if (pending() == 0) return 0;
+  if (millis() - _since < _window) return 0;
+  return flush();
+}
+
+int I2C_eeprom_scheduler::flush()
+{
+  if (_eeprom == NULL) return -1;
+  while (true)
+  {
+    // lowest page first
+    int index = -1;
+    for (uint8_t i = 0; i < _pages; i++)
+    {
+      if (!_slots[i].used) continue;
+      if ((index < 0) || (_slots[i].page < _slots[index].page)) index = i;
+    }
+    if (index < 0) return 0;
+    int rv = _program(index);
+    if (rv != 0) return rv;
+  }
+}
+
+uint8_t I2C_eeprom_scheduler::pending()
+{
+  uint8_t cnt = 0;
+  for (uint8_t i = 0; i < _pages; i++)
+  {
+    if (_slots[i].used) cnt++;
+  }
+  return cnt;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// cache page holding page, or a free one, -1 if none.
+int I2C_eeprom_scheduler::_slotOf(const uint16_t page)
+{
+  int index = -1;
+  for (uint8_t i = 0; i < _pages; i++)
+  {
+    if (!_slots[i].used)
+    {
+      if (index < 0) index = i;
+    }
+    else if (_slots[i].page == page) return i;
+  }
+  return index;
+}
+
+int I2C_eeprom_scheduler::_program(const uint8_t index)
+{
+  slot &s = _slots[index];
+  uint16_t addr = s.page * _pageSize + s.first;
+  int rv = _eeprom->writeBlock(addr, _cache + index * _pageSize + s.first, s.last - s.first + 1);
+  if (rv != 0) return rv;
+  s.used = false;
+  _programs++;
+  return 0;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,79 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_scheduler.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Write coalescing on top of I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// maximum number of pages held
+#ifndef I2C_EEPROM_SCHEDULER_PAGES
+#define I2C_EEPROM_SCHEDULER_PAGES  8
+#endif
+
+class I2C_eeprom_scheduler
+{
+public:
+  /**
+    * Holds writes in a page cache for a short window, so small writes
+    * to neighbouring fields cost one page program per page instead of
+    * one write cycle each.
+    *
+    * Writes to the same page are merged, the last write wins. The bytes
+    * between two merged ranges are read from the eeprom, so every page
+    * is programmed as one contiguous range. Pages are programmed in
+    * ascending order when the window has passed, on flush() or when a
+    * cache page is needed for another page.
+    *
+    * @param eeprom  The instance of I2C_eeprom to write to.
+    * @param cache   Buffer of the caller of pages * getPageSize() bytes.
+    * @param pages   Number of pages in the cache, max I2C_EEPROM_SCHEDULER_PAGES.
+    */
+  bool     begin(I2C_eeprom &eeprom, uint8_t *cache, const uint8_t pages);
+
+  // queues length bytes.
+  // return 0 if OK, error code of a page program that was needed otherwise.
+  int      writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length);
+  // reads length bytes, queued writes included. returns bytes read.
+  uint16_t readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length);
+
+  // milliseconds a write is held, counted from the first queued write.
+  // 0 = flush at the next poll(), default 10.
+  void     setWindow(const uint32_t window) { _window = window; };
+  uint32_t getWindow() { return _window; };
+  // flushes if the window has passed, call it often.
+  int      poll();
+  // barrier, programs all queued writes.
+  // return 0 if OK, error code of the first failed page otherwise.
+  int      flush();
+
+  // pages with queued writes.
+  uint8_t  pending();
+  // page programs done, for diagnostics.
+  uint32_t getPrograms() { return _programs; };
+
+private:
+  struct slot
+  {
+    uint16_t page;
+    uint8_t  first;     // queued range of the page
+    uint8_t  last;
+    bool     used;
+  };
+
+  I2C_eeprom * _eeprom = NULL;
+  uint8_t  * _cache;
+  uint8_t  _pages;
+  uint8_t  _pageSize;
+  uint32_t _window = 10;
+  uint32_t _since;          // millis() of the first queued write
+  uint32_t _programs = 0;
+  slot     _slots[I2C_EEPROM_SCHEDULER_PAGES];
+
+  int      _slotOf(const uint16_t page);
+  int      _program(const uint8_t index);
+};
+
+// -- END OF FILE --
@@ -0,0 +1,354 @@
+//
+//    FILE: I2C_eeprom_task.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: I/O task with a request queue for I2C_EEPROM library on RTOS targets
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// The queue is a linked list of the requests of the callers. step()
+// unlinks the first request, handles one page chunk of it without the
+// lock and links it at the end again if it is not done.
+// The flags done, _running and _stopping are only changed and read
+// with the lock held, so the threads see them in order.
+
+
+#include <I2C_eeprom_task.h>
+
+#if defined(I2C_EEPROM_TASK_FREERTOS) || defined(I2C_EEPROM_TASK_STD)
+
+
+I2C_eeprom_task::~I2C_eeprom_task()
+{
+  stop();
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  if (_mutex != NULL) vSemaphoreDelete(_mutex);
+#endif
+}
+
+bool I2C_eeprom_task::begin(I2C_eeprom &eeprom)
+{
+  if (isRunning()) return false;
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  if (_mutex == NULL) _mutex = xSemaphoreCreateMutex();
+  if (_mutex == NULL) return false;
+#endif
+  _eeprom  = &eeprom;
+  _head    = NULL;
+  _tail    = NULL;
+  _pending = 0;
+  return true;
+}
+
+bool I2C_eeprom_task::start(const int8_t core)
+{
+  if ((_eeprom == NULL) || isRunning()) return false;
+  _lock();
+  _stopping = false;
+  _running  = true;
+  _unlock();
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  BaseType_t rv = xTaskCreatePinnedToCore(_run, "I2C_eeprom", I2C_EEPROM_TASK_STACK,
+                    this, I2C_EEPROM_TASK_PRIORITY, &_task, core < 0 ? tskNO_AFFINITY : core);
+  if (rv != pdPASS)
+  {
+    _task = NULL;
+    _lock();
+    _running = false;
+    _unlock();
+    return false;
+  }
+#else
+  (void) core;
+  _thread = std::thread(&I2C_eeprom_task::_run, this);
+#endif
+  return true;
+}
+
+void I2C_eeprom_task::stop()
+{
+  if (!isRunning()) return;
+  _lock();
+  _stopping = true;
+  _unlock();
+  _signalWork();
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  while (isRunning()) vTaskDelay(1);
+  _task = NULL;
+#else
+  _thread.join();
+  _lock();
+  _running = false;
+  _unlock();
+#endif
+}
+
+bool I2C_eeprom_task::isRunning()
+{
+  _lock();
+  bool running = _running;
+  _unlock();
+  return running;
+}
+
+uint16_t I2C_eeprom_task::pending()
+{
+  _lock();
+  uint16_t n = _pending;
+  _unlock();
+  return n;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// REQUESTS
+//
+
+uint16_t I2C_eeprom_task::readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length)
+{
+  I2C_eeprom_request request;
+  if (!submit(request, I2C_eeprom_request::READ, memoryAddress, buffer, length)) return 0;
+  return wait(request);
+}
+
+int I2C_eeprom_task::writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+{
+  I2C_eeprom_request request;
+  if (!submit(request, I2C_eeprom_request::WRITE, memoryAddress, (uint8_t *)buffer, length)) return -1;
+  return wait(request);
+}
+
+int I2C_eeprom_task::updateBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+{
+  I2C_eeprom_request request;
+  if (!submit(request, I2C_eeprom_request::UPDATE, memoryAddress, (uint8_t *)buffer, length)) return -1;
+  return wait(request);
+}
+
+bool I2C_eeprom_task::submit(I2C_eeprom_request &request, const uint8_t type, const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length)
+{
+  if ((_eeprom == NULL) || (type > I2C_eeprom_request::UPDATE)) return false;
+
+  request.type     = type;
+  request.address  = memoryAddress;
+  request.buffer   = buffer;
+  request.length   = length;
+  request.position = 0;
+  request.result   = 0;
+  request.next     = NULL;
+  request.done     = (length == 0);   // not queued yet
+  if (request.done) return true;
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  request.waiter   = xTaskGetCurrentTaskHandle();
+#endif
+
+  _lock();
+  if (_tail == NULL) _head = &request;
+  else _tail->next = &request;
+  _tail = &request;
+  _pending++;
+  _unlock();
+  _signalWork();
+  return true;
+}
+
+bool I2C_eeprom_task::isDone(I2C_eeprom_request &request)
+{
+  _lock();
+  bool done = request.done;
+  _unlock();
+  return done;
+}
+
+int I2C_eeprom_task::wait(I2C_eeprom_request &request)
+{
+  if (isRunning())
+  {
+    // done is seen with the lock held, so result is complete
+    _waitDone(request);
+    return request.result;
+  }
+
+  // no I/O task, unlink and handle only this request. The requests
+  // of other callers are left to them or to a later I/O task.
+  _lock();
+  if (!request.done)
+  {
+    I2C_eeprom_request * previous = NULL;
+    I2C_eeprom_request * r = _head;
+    while ((r != NULL) && (r != &request))
+    {
+      previous = r;
+      r = r->next;
+    }
+    if (r != NULL)
+    {
+      if (previous == NULL) _head = r->next;
+      else previous->next = r->next;
+      if (_tail == r) _tail = previous;
+      r->next = NULL;
+      while (!_chunk(r));
+      r->done = true;
+      _pending--;
+    }
+  }
+  int rv = request.result;
+  _unlock();
+  return rv;
+}
+
+bool I2C_eeprom_task::step()
+{
+  _lock();
+  I2C_eeprom_request * request = _head;
+  if (request != NULL)
+  {
+    _head = request->next;
+    if (_head == NULL) _tail = NULL;
+    request->next = NULL;
+  }
+  _unlock();
+  if (request == NULL) return false;
+
+  bool done = _chunk(request);
+
+  // the caller may return and drop the request as soon as done is set,
+  // so the waiter is copied before that
+  void * waiter = NULL;
+  _lock();
+  if (done)
+  {
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+    waiter = request->waiter;
+#endif
+    request->done = true;
+    _pending--;
+  }
+  else
+  {
+    if (_tail == NULL) _head = request;
+    else _tail->next = request;
+    _tail = request;
+  }
+  _unlock();
+  if (done) _signalDone(waiter);
+  return true;
+}
+
+// handles one page chunk of request, returns true if it is done.
+bool I2C_eeprom_task::_chunk(I2C_eeprom_request *request)
+{
+  uint16_t address = request->address + request->position;
+  uint8_t  * buffer = request->buffer + request->position;
+  uint8_t  pageSize = _eeprom->getPageSize();
+  uint16_t cnt = pageSize - address % pageSize;
+  if (cnt > request->length - request->position) cnt = request->length - request->position;
+
+  bool done = false;
+  if (request->type == I2C_eeprom_request::READ)
+  {
+    uint16_t n = _eeprom->readBlock(address, buffer, cnt);
+    request->result += n;
+    done = (n != cnt);
+  }
+  else
+  {
+    int rv = (request->type == I2C_eeprom_request::WRITE)
+             ? _eeprom->writeBlock(address, buffer, cnt)
+             : _eeprom->updateBlock(address, buffer, cnt);
+    request->result = rv;
+    done = (rv != 0);
+  }
+  request->position += cnt;
+  return done || (request->position == request->length);
+}
+
+bool I2C_eeprom_task::_isStopping()
+{
+  _lock();
+  bool stopping = _stopping;
+  _unlock();
+  return stopping;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PORT
+//
+
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+
+void I2C_eeprom_task::_run(void *arg)
+{
+  I2C_eeprom_task * task = (I2C_eeprom_task *)arg;
+  while (true)
+  {
+    if (task->step()) continue;
+    if (task->_isStopping()) break;
+    task->_waitWork();
+  }
+  task->_lock();
+  task->_running = false;
+  task->_unlock();
+  vTaskDelete(NULL);
+}
+
+void I2C_eeprom_task::_lock()      { xSemaphoreTake(_mutex, portMAX_DELAY); }
+void I2C_eeprom_task::_unlock()    { xSemaphoreGive(_mutex); }
+void I2C_eeprom_task::_signalWork() { if (_task != NULL) xTaskNotifyGive(_task); }
+void I2C_eeprom_task::_waitWork()  { ulTaskNotifyTake(pdTRUE, portMAX_DELAY); }
+
+void I2C_eeprom_task::_signalDone(void *waiter)
+{
+  if (waiter != NULL) xTaskNotifyGive((TaskHandle_t)waiter);
+}
+
+void I2C_eeprom_task::_waitDone(I2C_eeprom_request &request)
+{
+  // a notification of an earlier request that was polled can be pending
+  while (!isDone(request)) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+#else
+
+void I2C_eeprom_task::_run()
+{
+  while (true)
+  {
+    if (step()) continue;
+    if (_isStopping()) break;
+    _waitWork();
+  }
+}
+
+void I2C_eeprom_task::_lock()      { _mutex.lock(); }
+void I2C_eeprom_task::_unlock()    { _mutex.unlock(); }
+void I2C_eeprom_task::_signalWork() { _work.notify_one(); }
+
+void I2C_eeprom_task::_waitWork()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _work.wait(lock, [this] { return (_head != NULL) || _stopping; });
+}
+
+void I2C_eeprom_task::_signalDone(void *waiter)
+{
+  (void) waiter;
+  // done is set with the lock held, so a waiter can not miss it
+  _finished.notify_all();
+}
+
+void I2C_eeprom_task::_waitDone(I2C_eeprom_request &request)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _finished.wait(lock, [&request] { return request.done; });
+}
+
+#endif
+
+#endif
+
+// -- END OF FILE --
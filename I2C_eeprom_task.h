@@ -0,0 +1,139 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_task.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: I/O task with a request queue for I2C_EEPROM library on RTOS targets
+//
+
+#include <I2C_eeprom.h>
+
+// port, FreeRTOS on ESP32, std::thread on a host, e.g. for the unit tests.
+// other targets can define one of them before including this file.
+#if !defined(I2C_EEPROM_TASK_FREERTOS) && !defined(I2C_EEPROM_TASK_STD)
+#if defined(ESP32)
+#define I2C_EEPROM_TASK_FREERTOS
+#elif defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+#define I2C_EEPROM_TASK_STD
+#endif
+#endif
+
+#if defined(I2C_EEPROM_TASK_FREERTOS) || defined(I2C_EEPROM_TASK_STD)
+
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#else
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// FreeRTOS task settings for start()
+#ifndef I2C_EEPROM_TASK_STACK
+#define I2C_EEPROM_TASK_STACK     2048
+#endif
+#ifndef I2C_EEPROM_TASK_PRIORITY
+#define I2C_EEPROM_TASK_PRIORITY  5
+#endif
+
+
+// A request is owned by the caller and must stay valid until it is done.
+// The queue links the requests, so it has no size limit and no allocation.
+struct I2C_eeprom_request
+{
+  enum { READ, WRITE, UPDATE };
+
+  uint8_t  type;
+  uint16_t address;
+  uint8_t  * buffer;
+  uint16_t length;
+  uint16_t position;         // bytes handled
+  int      result;           // bytes read, or 0 / error code of a write
+  bool     done;             // changed with the lock held
+  I2C_eeprom_request * next;
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  TaskHandle_t waiter;
+#endif
+};
+
+
+class I2C_eeprom_task
+{
+public:
+  /**
+    * Lets one I/O task own the eeprom, other tasks queue their reads
+    * and writes instead of locking the eeprom and Wire themselves.
+    *
+    * The I/O task handles one page chunk of the first request and then
+    * moves that request to the end of the queue, so a short read waits
+    * at most one page chunk per queued request instead of a whole
+    * multi-page write. The queue lock is only held to link and unlink
+    * requests, never during bus access.
+    *
+    * After begin() the eeprom, and other devices on the same Wire,
+    * should only be accessed through this class.
+    */
+  ~I2C_eeprom_task();
+
+  bool     begin(I2C_eeprom &eeprom);
+  // starts the I/O task, core = -1 is any core (FreeRTOS only).
+  bool     start(const int8_t core = -1);
+  // waits until the queue is handled and stops the I/O task.
+  void     stop();
+  bool     isRunning();
+
+  // blocking, same return values as I2C_eeprom.
+  // Without a running I/O task the caller handles its own request.
+  uint16_t readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length);
+  int      writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length);
+  int      updateBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length);
+
+  // non blocking, fills and queues request.
+  bool     submit(I2C_eeprom_request &request, const uint8_t type, const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length);
+  bool     isDone(I2C_eeprom_request &request);
+  // waits until request is done, returns its result. Without a running
+  // I/O task only this request is handled, with the lock held so the
+  // callers of wait() do not access the bus at the same time.
+  int      wait(I2C_eeprom_request &request);
+
+  // handles one page chunk of the queue, called by the I/O task.
+  // returns false if the queue is empty.
+  bool     step();
+  uint16_t pending();
+
+private:
+  I2C_eeprom * _eeprom = NULL;
+  I2C_eeprom_request * _head = NULL;
+  I2C_eeprom_request * _tail = NULL;
+  // changed and read with the lock held
+  uint16_t _pending  = 0;
+  bool     _running  = false;
+  bool     _stopping = false;
+
+#if defined(I2C_EEPROM_TASK_FREERTOS)
+  SemaphoreHandle_t _mutex = NULL;
+  TaskHandle_t _task = NULL;
+  static void _run(void *arg);
+#else
+  std::mutex  _mutex;
+  std::condition_variable _work;
+  std::condition_variable _finished;
+  std::thread _thread;
+  void     _run();
+#endif
+
+  bool     _chunk(I2C_eeprom_request *request);
+  bool     _isStopping();
+  void     _lock();
+  void     _unlock();
+  void     _signalWork();
+  void     _waitWork();
+  void     _signalDone(void *waiter);
+  void     _waitDone(I2C_eeprom_request &request);
+};
+
+#endif
+
+// -- END OF FILE --
@@ -0,0 +1,371 @@
+//
+//    FILE: I2C_eeprom_timeseries.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Time series of samples with timestamp seek for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// page    { seq, time, count, crc8 } { delta, sample } * count
+// seq     increases by one per page, 0xFFFFFFFF = blank page
+// time    of the first sample, the time of a sample is time + delta
+//
+// Pages are written in order and wrap around, so from page 0 up to the
+// newest page seq increases and the pages after it are blank or older.
+// A page that fails its crc8 is a reset during its write, begin() then
+// takes the page before it as newest.
+
+
+#include <I2C_eeprom_timeseries.h>
+
+#define I2C_EEPROM_TIMESERIES_BLANK  0xFFFFFFFFUL
+
+
+bool I2C_eeprom_timeseries::begin(I2C_eeprom &eeprom, uint8_t *page, const uint16_t firstPage,
+                                  const uint16_t pages, const uint8_t sampleSize)
+{
+  _eeprom     = NULL;
+  _pageSize   = eeprom.getPageSize();
+  _recordSize = sizeof(uint16_t) + sampleSize;
+  _slots      = (_pageSize <= I2C_EEPROM_TIMESERIES_HEADER) ? 0 : (_pageSize - I2C_EEPROM_TIMESERIES_HEADER) / _recordSize;
+  if ((_slots == 0) || (pages < 2) || (page == NULL)) return false;
+
+  _eeprom     = &eeprom;
+  _page       = page;
+  _firstPage  = firstPage;
+  _pages      = pages;
+  _sampleSize = sampleSize;
+  _current    = 0;
+  _stored     = 0;
+  _seq        = 0;
+  _lastTime   = 0;
+  _hasTime    = false;
+  _reads      = 0;
+  _cursorPage = I2C_EEPROM_TIMESERIES_NONE;
+  _newPage();
+
+  uint8_t  header[I2C_EEPROM_TIMESERIES_HEADER];
+  uint32_t first;
+  uint32_t seq;
+  if (!_readHeader(0, header)) return false;
+  memcpy(&first, header, sizeof(first));
+  if (first == I2C_EEPROM_TIMESERIES_BLANK) return true;
+
+  // binary search for the newest page
+  uint16_t lo = 0;
+  uint16_t hi = _pages - 1;
+  while (lo < hi)
+  {
+    uint16_t mid = (lo + hi + 1) / 2;
+    if (!_readHeader(mid, header)) return false;
+    memcpy(&seq, header, sizeof(seq));
+    if ((seq != I2C_EEPROM_TIMESERIES_BLANK) && (seq > first)) lo = mid;
+    else hi = mid - 1;
+  }
+
+  uint16_t head = lo;
+  bool     torn = false;
+  if (!_readPage(head, _page))
+  {
+    torn = true;
+    uint16_t prev = (head + _pages - 1) % _pages;
+    if (!_readPage(prev, _page))
+    {
+      memcpy(&seq, _page, sizeof(seq));
+      if (seq != I2C_EEPROM_TIMESERIES_BLANK) return false;
+      // the torn page is the only one
+      _current = head;
+      _newPage();
+      return true;
+    }
+    head = prev;
+  }
+
+  // wrapped if the page after the newest (and the torn one) is not blank
+  uint16_t after = (head + (torn ? 2 : 1)) % _pages;
+  if (!_readHeader(after, header)) return false;
+  memcpy(&seq, header, sizeof(seq));
+  uint16_t used = head + 1;
+  if (seq != I2C_EEPROM_TIMESERIES_BLANK) used = torn ? _pages - 1 : _pages;
+
+  memcpy(&_seq, _page, sizeof(_seq));
+  _lastTime = _time(_page, _page[8] - 1);
+  _hasTime  = true;
+  _current  = head;
+  _stored   = used - 1;
+  _dirty    = false;
+  // a full page is done, continue on the next one
+  if (_page[8] == _slots) _nextPage();
+  return true;
+}
+
+bool I2C_eeprom_timeseries::format()
+{
+  if (_eeprom == NULL) return false;
+
+  _current    = 0;
+  _stored     = 0;
+  _seq        = 0;
+  _lastTime   = 0;
+  _hasTime    = false;
+  _cursorPage = I2C_EEPROM_TIMESERIES_NONE;
+  _newPage();
+  return _eeprom->erase(_address(0, 0), (uint32_t)_pages * _pageSize, 0xFF) == 0;
+}
+
+int I2C_eeprom_timeseries::append(const uint32_t time, const void *sample)
+{
+  if (_eeprom == NULL) return -1;
+  if (_hasTime && (time < _lastTime)) return -1;
+
+  // a full page not written yet, or a time too far after the
+  // first sample of the page for a 16 bit delta, needs a new page.
+  uint8_t count = _page[8];
+  if ((count == _slots) || ((count > 0) && (time - _time(_page, 0) > 0xFFFF)))
+  {
+    // not dirty => written by flush() already
+    if (_dirty)
+    {
+      int rv = _writePage();
+      if (rv != 0) return rv;
+    }
+    _nextPage();
+    count = 0;
+  }
+  if (count == 0) memcpy(_page + 4, &time, sizeof(time));
+
+  uint8_t  * record = _page + I2C_EEPROM_TIMESERIES_HEADER + count * _recordSize;
+  uint16_t delta = time - _time(_page, 0);
+  memcpy(record, &delta, sizeof(delta));
+  memcpy(record + sizeof(delta), sample, _sampleSize);
+  _page[8]  = count + 1;
+  _lastTime = time;
+  _hasTime  = true;
+  _dirty    = true;
+
+  if (_page[8] < _slots) return 0;
+  int rv = _writePage();
+  if (rv == 0) _nextPage();
+  return rv;
+}
+
+int I2C_eeprom_timeseries::flush()
+{
+  if (_eeprom == NULL) return -1;
+  if (!_dirty) return 0;
+  return _writePage();
+}
+
+bool I2C_eeprom_timeseries::seekTime(const uint32_t time)
+{
+  _cursorPage = I2C_EEPROM_TIMESERIES_NONE;
+  if (_eeprom == NULL) return false;
+  _reads = 0;
+
+  // binary search over the time of the first sample of the written
+  // pages and the page buffer, for the first page from time on.
+  uint8_t  header[I2C_EEPROM_TIMESERIES_HEADER];
+  uint16_t lo = 0;
+  uint16_t hi = getPages();
+  while (lo < hi)
+  {
+    uint16_t mid = (lo + hi) / 2;
+    const uint8_t * p = _page;
+    if (mid < _stored)
+    {
+      if (!_readHeader(_physical(mid), header)) return false;
+      p = header;
+    }
+    if (_time(p, 0) < time) lo = mid + 1;
+    else hi = mid;
+  }
+
+  // equal times can start in the page before it
+  _cursorPage   = _physical((lo == 0) ? 0 : lo - 1);
+  _cursorIndex  = 0;
+  _cursorLoaded = false;
+  if (lo == 0) return true;
+
+  uint8_t buffer[_pageSize];
+  const uint8_t * p = _page;
+  if (_cursorPage != _current)
+  {
+    if (!_readPage(_cursorPage, buffer)) return true;
+    p = buffer;
+    _cursorCount  = buffer[8];
+    _cursorTime   = _time(buffer, 0);
+    _cursorLoaded = true;
+  }
+  while ((_cursorIndex < p[8]) && (_time(p, _cursorIndex) < time)) _cursorIndex++;
+  return true;
+}
+
+bool I2C_eeprom_timeseries::seekLatest(const uint16_t n)
+{
+  _cursorPage = I2C_EEPROM_TIMESERIES_NONE;
+  if (_eeprom == NULL) return false;
+  _reads = 0;
+
+  uint16_t remaining = n;
+  _cursorPage   = _current;
+  _cursorLoaded = false;
+  if (remaining <= _page[8])
+  {
+    _cursorIndex = _page[8] - remaining;
+    return true;
+  }
+  remaining -= _page[8];
+
+  // walk back over the written pages, one header read per page
+  uint8_t header[I2C_EEPROM_TIMESERIES_HEADER];
+  for (uint16_t logical = _stored; logical > 0; logical--)
+  {
+    _cursorPage = _physical(logical - 1);
+    if (!_readHeader(_cursorPage, header)) return false;
+    _cursorCount  = (header[8] > _slots) ? 0 : header[8];
+    _cursorTime   = _time(header, 0);
+    _cursorLoaded = true;
+    if (remaining <= _cursorCount)
+    {
+      _cursorIndex = _cursorCount - remaining;
+      return true;
+    }
+    remaining -= _cursorCount;
+  }
+  // less than n samples, all of them
+  _cursorIndex = 0;
+  return true;
+}
+
+bool I2C_eeprom_timeseries::next(uint32_t &time, void *sample)
+{
+  if (_eeprom == NULL) return false;
+
+  uint8_t header[I2C_EEPROM_TIMESERIES_HEADER];
+  for (uint16_t i = 0; (i <= _pages) && (_cursorPage != I2C_EEPROM_TIMESERIES_NONE); i++)
+  {
+    if (_cursorPage == _current)
+    {
+      // the cursor stays at the end, for samples appended later
+      _cursorLoaded = false;
+      if (_cursorIndex >= _page[8]) return false;
+      uint8_t * record = _page + I2C_EEPROM_TIMESERIES_HEADER + _cursorIndex * _recordSize;
+      time = _time(_page, _cursorIndex);
+      memcpy(sample, record + sizeof(uint16_t), _sampleSize);
+      _cursorIndex++;
+      return true;
+    }
+    if (!_cursorLoaded)
+    {
+      if (!_readHeader(_cursorPage, header)) return false;
+      _cursorCount  = (header[8] > _slots) ? 0 : header[8];
+      _cursorTime   = _time(header, 0);
+      _cursorLoaded = true;
+    }
+    if (_cursorIndex < _cursorCount)
+    {
+      uint8_t record[_recordSize];
+      uint16_t address = _address(_cursorPage, I2C_EEPROM_TIMESERIES_HEADER + _cursorIndex * _recordSize);
+      if (_eeprom->readBlock(address, record, _recordSize) != _recordSize) return false;
+      uint16_t delta;
+      memcpy(&delta, record, sizeof(delta));
+      time = _cursorTime + delta;
+      memcpy(sample, record + sizeof(delta), _sampleSize);
+      _cursorIndex++;
+      return true;
+    }
+    _cursorPage   = (_cursorPage + 1) % _pages;
+    _cursorIndex  = 0;
+    _cursorLoaded = false;
+  }
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+uint16_t I2C_eeprom_timeseries::_address(const uint16_t page, const uint8_t offset)
+{
+  return (_firstPage + page) * _pageSize + offset;
+}
+
+// written page logical, 0 = oldest, _stored = the page buffer
+uint16_t I2C_eeprom_timeseries::_physical(const uint16_t logical)
+{
+  return (_current + _pages - _stored + logical) % _pages;
+}
+
+bool I2C_eeprom_timeseries::_readHeader(const uint16_t page, uint8_t *header)
+{
+  _reads++;
+  return _eeprom->readBlock(_address(page, 0), header, I2C_EEPROM_TIMESERIES_HEADER) == I2C_EEPROM_TIMESERIES_HEADER;
+}
+
+// false if not a complete page
+bool I2C_eeprom_timeseries::_readPage(const uint16_t page, uint8_t *buffer)
+{
+  if (_eeprom->readBlock(_address(page, 0), buffer, _pageSize) != _pageSize) return false;
+  uint32_t seq;
+  memcpy(&seq, buffer, sizeof(seq));
+  uint8_t count = buffer[8];
+  if ((seq == I2C_EEPROM_TIMESERIES_BLANK) || (count == 0) || (count > _slots)) return false;
+  return buffer[9] == _crc8(_crc8(0, buffer, 9), buffer + I2C_EEPROM_TIMESERIES_HEADER, count * _recordSize);
+}
+
+// time of sample index, 0 = the time in the header
+uint32_t I2C_eeprom_timeseries::_time(const uint8_t *buffer, const uint8_t index)
+{
+  uint32_t time;
+  memcpy(&time, buffer + 4, sizeof(time));
+  if (index == 0) return time;
+  uint16_t delta;
+  memcpy(&delta, buffer + I2C_EEPROM_TIMESERIES_HEADER + index * _recordSize, sizeof(delta));
+  return time + delta;
+}
+
+// empty page buffer with the current seq
+void I2C_eeprom_timeseries::_newPage()
+{
+  memcpy(_page, &_seq, sizeof(_seq));
+  memset(_page + 4, 0, sizeof(uint32_t));
+  _page[8] = 0;
+  _dirty   = false;
+}
+
+// the page buffer moves to the next page, when wrapped over the oldest
+void I2C_eeprom_timeseries::_nextPage()
+{
+  _current = (_current + 1) % _pages;
+  if (_stored < _pages - 1) _stored++;
+  _seq++;
+  _newPage();
+}
+
+int I2C_eeprom_timeseries::_writePage()
+{
+  uint8_t count = _page[8];
+  _page[9] = _crc8(_crc8(0, _page, 9), _page + I2C_EEPROM_TIMESERIES_HEADER, count * _recordSize);
+  int rv = _eeprom->writeBlock(_address(_current, 0), _page, I2C_EEPROM_TIMESERIES_HEADER + count * _recordSize);
+  if (rv == 0) _dirty = false;
+  return rv;
+}
+
+uint8_t I2C_eeprom_timeseries::_crc8(uint8_t crc, const uint8_t *data, const uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,103 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_timeseries.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Time series of samples with timestamp seek for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// bytes of every page used for { seq, time, count, crc8 }
+#define I2C_EEPROM_TIMESERIES_HEADER  10
+
+// no page
+#define I2C_EEPROM_TIMESERIES_NONE    0xFFFF
+
+class I2C_eeprom_timeseries
+{
+public:
+  /**
+    * Appends timestamped samples of a fixed size to a circular region
+    * of the EEPROM, the oldest page is overwritten when it is full.
+    *
+    * Samples are collected in a page buffer and every page is written
+    * with a single writeBlock(). writeBlock() splits a page in chunks of
+    * I2C_TWIBUFFERSIZE, on AVR (30 bytes) a 64 byte page takes 3 write
+    * cycles, a reset in between is caught by the crc8 of the page.
+    * A page holds a header with a sequence number and the
+    * time of its first sample, a sample holds the 16 bit time after it.
+    * begin() finds the newest page and seekTime() the page of a time by
+    * a binary search over the page headers.
+    *
+    * @param eeprom     The instance of I2C_eeprom to use.
+    * @param page       Buffer of the caller of getPageSize() bytes.
+    * @param firstPage  First page of the region.
+    * @param pages      Number of pages of the region, 2 or more.
+    * @param sampleSize Bytes of a sample.
+    * @return True if the region holds a series or is blank,
+    *         false otherwise (call format()).
+    */
+  bool     begin(I2C_eeprom &eeprom, uint8_t *page, const uint16_t firstPage,
+                 const uint16_t pages, const uint8_t sampleSize);
+
+  // erases the region.
+  bool     format();
+
+  // adds a sample, time must not be before the time of the previous one.
+  // A full page is written at once.
+  // return 0 if OK, -1 if time is earlier, error code otherwise.
+  int      append(const uint32_t time, const void *sample);
+  // writes the samples of the page buffer, e.g. before power down.
+  // The page is written again when it is full, not when a time too far
+  // for the 16 bit delta starts the next page.
+  int      flush();
+
+  // position before the first sample with a time >= time.
+  bool     seekTime(const uint32_t time);
+  // position before the last n samples, or the oldest if there are less.
+  bool     seekLatest(const uint16_t n);
+  // returns the next sample, also ones appended after the seek.
+  bool     next(uint32_t &time, void *sample);
+
+  // pages with samples, the page buffer included.
+  uint16_t getPages()     { return (_eeprom == NULL) ? 0 : _stored + (_page[8] > 0 ? 1 : 0); };
+  uint8_t  getSlots()     { return _slots; };
+  uint32_t getLastTime()  { return _lastTime; };
+  // header reads since the last begin() or seek, for diagnostics.
+  uint16_t getReads()     { return _reads; };
+
+private:
+  I2C_eeprom * _eeprom = NULL;
+  uint8_t  * _page;
+  uint16_t _firstPage;
+  uint16_t _pages;
+  uint8_t  _pageSize;
+  uint8_t  _sampleSize;
+  uint8_t  _recordSize;
+  uint8_t  _slots;
+  uint16_t _current;    // page of the page buffer
+  uint16_t _stored;     // written pages before it
+  uint32_t _seq;
+  uint32_t _lastTime;
+  bool     _hasTime;
+  bool     _dirty;
+  uint16_t _reads;
+  uint16_t _cursorPage;
+  uint8_t  _cursorIndex;
+  uint8_t  _cursorCount;
+  uint32_t _cursorTime;
+  bool     _cursorLoaded;   // count and time of the cursor page are read
+
+  uint16_t _address(const uint16_t page, const uint8_t offset);
+  uint16_t _physical(const uint16_t logical);
+  bool     _readHeader(const uint16_t page, uint8_t *header);
+  bool     _readPage(const uint16_t page, uint8_t *buffer);
+  uint32_t _time(const uint8_t *buffer, const uint8_t index);
+  void     _newPage();
+  void     _nextPage();
+  int      _writePage();
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint8_t length);
+};
+
+// -- END OF FILE --
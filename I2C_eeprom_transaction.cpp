@@ -0,0 +1,122 @@
+//
+//    FILE: I2C_eeprom_transaction.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Atomic commits over several cyclic stores for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// A write to a cyclic store goes to the next slot and keeps the previous
+// version intact. So a transaction is: write all participants, then write
+// one commit record with their versions. After a reset, participants with
+// a newer version than the last commit record are reverted.
+// Between two commits a participant may be written at most slots - 1 times.
+
+
+#include <I2C_eeprom_transaction.h>
+
+
+bool I2C_eeprom_transaction::begin(I2C_eeprom &eeprom, const uint8_t pageSize, const uint16_t totalPages, const uint16_t firstPage)
+{
+  _valid = false;
+  return _log.begin(eeprom, pageSize, totalPages, firstPage);
+}
+
+bool I2C_eeprom_transaction::begin(I2C_eeprom_partition_table &table, const char *name)
+{
+  _valid = false;
+  return _log.begin(table, name);
+}
+
+bool I2C_eeprom_transaction::format()
+{
+  _valid = false;
+  return _log.format();
+}
+
+bool I2C_eeprom_transaction::add(I2C_eeprom_transactional &store)
+{
+  if (_count >= I2C_EEPROM_TRANSACTION_STORES) return false;
+  store._transactional = true;
+  _stores[_count++] = &store;
+  return true;
+}
+
+bool I2C_eeprom_transaction::recover()
+{
+  if (!_readLast()) return commit();
+  return rollback();
+}
+
+bool I2C_eeprom_transaction::commit()
+{
+  I2C_eeprom_commit_record record;
+  memset(&record, 0, sizeof(record));
+  record.count = _count;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    record.versions[i] = _stores[i]->getVersion();
+  }
+  record.crc = _crc(record);
+
+  if (!_log.write(record)) return false;
+  _last  = record;
+  _valid = true;
+  return true;
+}
+
+bool I2C_eeprom_transaction::rollback()
+{
+  if (!_valid) return false;
+  bool rv = true;
+  uint8_t n = _last.count < _count ? _last.count : _count;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    if (_stores[i]->getVersion() != _last.versions[i])
+    {
+      rv &= _stores[i]->revert(_last.versions[i]);
+    }
+  }
+  return rv;
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// reads the last commit record, a torn record falls back to the one before.
+bool I2C_eeprom_transaction::_readLast()
+{
+  for (uint8_t attempt = 0; attempt < 2; attempt++)
+  {
+    if (!_log.read(_last)) return false;
+    if (_last.crc == _crc(_last) && _last.count <= I2C_EEPROM_TRANSACTION_STORES)
+    {
+      _valid = true;
+      return true;
+    }
+    uint32_t version = _log.getVersion();
+    if (version == 0 || !_log.revert(version - 1)) return false;
+  }
+  return false;
+}
+
+// CRC-8 (poly 0x07) over versions and count
+uint8_t I2C_eeprom_transaction::_crc(const I2C_eeprom_commit_record &record)
+{
+  const uint8_t * data = (const uint8_t *)&record;
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < sizeof(record.versions) + sizeof(record.count); i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,66 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_transaction.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Atomic commits over several cyclic stores for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+#include <I2C_eeprom_cyclic_store.h>
+
+// maximum number of stores in one transaction
+#ifndef I2C_EEPROM_TRANSACTION_STORES
+#define I2C_EEPROM_TRANSACTION_STORES  4
+#endif
+
+struct I2C_eeprom_commit_record
+{
+  uint32_t versions[I2C_EEPROM_TRANSACTION_STORES];
+  uint8_t  count;
+  uint8_t  crc;
+};
+
+class I2C_eeprom_transaction
+{
+public:
+  /**
+    * Initializes the commit log in the given region of the eeprom.
+    *
+    * The commit log is a cyclic store of small commit records, each
+    * holding the versions of all participating stores.
+    */
+  bool     begin(I2C_eeprom &eeprom, const uint8_t pageSize, const uint16_t totalPages, const uint16_t firstPage = 0);
+  bool     begin(I2C_eeprom_partition_table &table, const char *name);
+  bool     format();
+
+  // adds a participant, call after its begin() and before recover().
+  // participants do not use delta mode while in a transaction.
+  bool     add(I2C_eeprom_transactional &store);
+
+  // reverts participants written after the last commit, e.g. due to a
+  // reset between two writes. Call once after begin() and add().
+  // Without commit record the current state is committed.
+  bool     recover();
+
+  // makes all writes to the participants since the last commit durable,
+  // costs one write of the commit record.
+  bool     commit();
+
+  // reverts participants written since the last commit.
+  bool     rollback();
+
+  uint8_t  count() { return _count; };
+
+private:
+  I2C_eeprom_cyclic_store<I2C_eeprom_commit_record> _log;
+  I2C_eeprom_transactional * _stores[I2C_EEPROM_TRANSACTION_STORES];
+  I2C_eeprom_commit_record   _last;
+  uint8_t  _count = 0;
+  bool     _valid = false;   // _last holds the last commit
+
+  bool     _readLast();
+  uint8_t  _crc(const I2C_eeprom_commit_record &record);
+};
+
+// -- END OF FILE --
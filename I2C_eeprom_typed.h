@@ -0,0 +1,207 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_typed.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Supplemental typed accessors for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// Number of bytes fetched per transaction when iterating an array.
+// Defaults to the TWI buffer so every batch is a single bus read.
+#ifndef I2C_EEPROM_ARRAY_BATCH
+#define I2C_EEPROM_ARRAY_BATCH I2C_TWIBUFFERSIZE
+#endif
+
+/**
+ * @brief Typed view on a single value stored in an eeprom.
+ *
+ * Binds a type and a memory address together so that callers do not
+ * need to compute offsets or sizes themselves.
+ *
+ * @tparam T the type of the value, should be a pure DTO (see
+ * I2C_eeprom_cyclic_store for the restrictions that apply).
+ */
+template <typename T>
+class I2C_eeprom_var
+{
+public:
+    /**
+      * @param eeprom The instance of I2C_eeprom to use.
+      * @param memoryAddress The address of the first byte of the value.
+      */
+    I2C_eeprom_var(I2C_eeprom &eeprom, const uint16_t memoryAddress)
+        : _eeprom(&eeprom), _address(memoryAddress) {}
+
+    /**
+      * @brief Read the value from the eeprom.
+      *
+      * @param value A reference to the buffer to read the value into.
+      * @return True if the value was read successfully, false otherwise.
+      */
+    bool get(T &value) const
+    {
+        return _eeprom->readBlock(_address, (uint8_t *)&value, sizeof(T)) == sizeof(T);
+    }
+
+    /**
+      * @brief Write the value to the eeprom unconditionally.
+      *
+      * @return True if the value was written successfully, false otherwise.
+      */
+    bool put(const T &value)
+    {
+        return _eeprom->writeBlock(_address, (const uint8_t *)&value, sizeof(T)) == 0;
+    }
+
+    /**
+      * @brief Write the value to the eeprom, skipping unchanged pages.
+      *
+      * @return True if the value is stored, false otherwise.
+      */
+    bool update(const T &value)
+    {
+        return _eeprom->updateBlock(_address, (const uint8_t *)&value, sizeof(T)) == 0;
+    }
+
+    uint16_t address() const { return _address; }
+
+private:
+    I2C_eeprom *_eeprom;
+    uint16_t _address;
+};
+
+/**
+ * @brief Typed view on a contiguous array of values stored in an eeprom.
+ *
+ * Element accessors use a single transaction per element, the range
+ * accessors and forEach() fetch as many contiguous elements per bus
+ * transaction as fit into I2C_EEPROM_ARRAY_BATCH.
+ *
+ * @tparam T the type of the elements, should be a pure DTO.
+ */
+template <typename T>
+class I2C_eeprom_array
+{
+public:
+    /**
+      * @param eeprom The instance of I2C_eeprom to use.
+      * @param memoryAddress The address of the first element.
+      * @param count The number of elements in the array.
+      */
+    I2C_eeprom_array(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t count)
+        : _eeprom(&eeprom), _address(memoryAddress), _count(count) {}
+
+    uint16_t size() const { return _count; }
+    uint16_t address(const uint16_t index) const { return _address + index * sizeof(T); }
+
+    /**
+      * @brief Returns a typed view on a single element.
+      */
+    I2C_eeprom_var<T> operator[](const uint16_t index) const
+    {
+        return I2C_eeprom_var<T>(*_eeprom, address(index));
+    }
+
+    bool get(const uint16_t index, T &value) const { return get(index, &value, 1) == 1; }
+    bool put(const uint16_t index, const T &value) { return put(index, &value, 1); }
+    bool update(const uint16_t index, const T &value) { return update(index, &value, 1); }
+
+    /**
+      * @brief Read a range of elements with one bulk read.
+      *
+      * @param first Index of the first element to read.
+      * @param values Buffer large enough to hold count elements.
+      * @param count The number of elements to read, clipped to the array.
+      * @return The number of elements read, 0 if the range exceeds
+      * the 16 bit length of a transfer.
+      */
+    uint16_t get(const uint16_t first, T *values, uint16_t count) const
+    {
+        count = _clip(first, count);
+        if (!_fits(count))
+            return 0;
+        uint16_t bytes = _eeprom->readBlock(address(first), (uint8_t *)values, count * sizeof(T));
+        return bytes / sizeof(T);
+    }
+
+    /**
+      * @brief Write a range of elements with one bulk write.
+      *
+      * @return True if all elements were written, false otherwise.
+      */
+    bool put(const uint16_t first, const T *values, const uint16_t count)
+    {
+        if ((_clip(first, count) != count) || !_fits(count))
+            return false;
+        return _eeprom->writeBlock(address(first), (const uint8_t *)values, count * sizeof(T)) == 0;
+    }
+
+    /**
+      * @brief Write a range of elements, skipping pages that are unchanged.
+      *
+      * @return True if all elements are stored, false otherwise.
+      */
+    bool update(const uint16_t first, const T *values, const uint16_t count)
+    {
+        if ((_clip(first, count) != count) || !_fits(count))
+            return false;
+        return _eeprom->updateBlock(address(first), (const uint8_t *)values, count * sizeof(T)) == 0;
+    }
+
+    /**
+      * @brief Visit a range of elements in order.
+      *
+      * Elements are fetched in batches so that a scan over the array
+      * costs one address phase per batch instead of one per element.
+      *
+      * @param first Index of the first element to visit.
+      * @param count The number of elements to visit, clipped to the array.
+      * @param callback Called as callback(index, value) for each element,
+      * return false from the callback to stop the iteration.
+      * @return The number of elements visited.
+      */
+    template <typename F>
+    uint16_t forEach(const uint16_t first, uint16_t count, F callback) const
+    {
+        const uint16_t perBatch = sizeof(T) < I2C_EEPROM_ARRAY_BATCH ? I2C_EEPROM_ARRAY_BATCH / sizeof(T) : 1;
+        T batch[perBatch];
+
+        count = _clip(first, count);
+        uint16_t index = first;
+        uint16_t visited = 0;
+        while (visited < count)
+        {
+            uint16_t n = count - visited;
+            if (n > perBatch) n = perBatch;
+            if (get(index, batch, n) != n)
+                return visited;
+
+            for (uint16_t i = 0; i < n; i++, index++, visited++)
+            {
+                if (!callback(index, (const T &)batch[i]))
+                    return visited + 1;
+            }
+        }
+        return visited;
+    }
+
+private:
+    I2C_eeprom *_eeprom;
+    uint16_t _address;
+    uint16_t _count;
+
+    uint16_t _clip(const uint16_t first, const uint16_t count) const
+    {
+        if (first >= _count)
+            return 0;
+        return (count > _count - first) ? _count - first : count;
+    }
+
+    // the length of a bulk transfer is 16 bit.
+    bool _fits(const uint16_t count) const
+    {
+        return (uint32_t)count * sizeof(T) <= 0xFFFF;
+    }
+};
@@ -0,0 +1,258 @@
+//
+//    FILE: I2C_eeprom_wear.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Per page write counting for I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+//
+// LAYOUT:
+// snapshot { seq, crc8, counters[groups] } * slots
+//
+// save() writes the counters before the header, a reset in between
+// leaves a snapshot with a bad crc and load() takes the previous one.
+
+
+#include <I2C_eeprom_wear.h>
+
+#define I2C_EEPROM_WEAR_HEADER  5   // seq + crc8
+
+
+bool I2C_eeprom_wear::begin(I2C_eeprom &eeprom, uint32_t *counters, const uint16_t groups)
+{
+  if (counters == NULL || groups == 0) return false;
+
+  uint16_t pages = eeprom.getDeviceSize() / eeprom.getPageSize();
+  _eeprom        = &eeprom;
+  _counters      = counters;
+  _groups        = groups;
+  _pagesPerGroup = (pages + groups - 1) / groups;
+  _pageSize      = eeprom.getPageSize();
+  _interval      = 0;
+  _slots         = 0;
+  reset();
+
+  eeprom.setWearMap(this);
+  return true;
+}
+
+bool I2C_eeprom_wear::begin(I2C_eeprom &eeprom, uint32_t *counters, const uint16_t groups,
+                            const uint16_t firstPage, const uint16_t pages)
+{
+  if (!begin(eeprom, counters, groups)) return false;
+
+  uint16_t size = I2C_EEPROM_WEAR_HEADER + groups * sizeof(uint32_t);
+  _firstPage = firstPage;
+  _slotPages = (size + _pageSize - 1) / _pageSize;
+  _slots     = pages / _slotPages;
+  if (_slots < 2)
+  {
+    _slots = 0;
+    return false;
+  }
+  return _load();
+}
+
+void I2C_eeprom_wear::end()
+{
+  if (_eeprom == NULL) return;
+  _eeprom->setWearMap(NULL);
+  _eeprom = NULL;
+}
+
+void I2C_eeprom_wear::count(const uint16_t memoryAddress)
+{
+  uint16_t group = getGroup(memoryAddress);
+  if (group >= _groups) return;
+  _counters[group]++;
+  _unsaved++;
+}
+
+void I2C_eeprom_wear::reset()
+{
+  memset(_counters, 0, _groups * sizeof(uint32_t));
+  _unsaved = 0;
+}
+
+uint16_t I2C_eeprom_wear::getGroup(const uint16_t memoryAddress)
+{
+  return (memoryAddress / _pageSize) / _pagesPerGroup;
+}
+
+uint32_t I2C_eeprom_wear::getCount(const uint16_t group)
+{
+  if (group >= _groups) return 0;
+  return _counters[group];
+}
+
+uint32_t I2C_eeprom_wear::getTotal()
+{
+  uint32_t total = 0;
+  for (uint16_t g = 0; g < _groups; g++) total += _counters[g];
+  return total;
+}
+
+uint32_t I2C_eeprom_wear::getMax()
+{
+  uint32_t mx = 0;
+  for (uint16_t g = 0; g < _groups; g++)
+  {
+    if (_counters[g] > mx) mx = _counters[g];
+  }
+  return mx;
+}
+
+uint32_t I2C_eeprom_wear::getRemaining(const uint32_t endurance)
+{
+  uint32_t mx = getMax();
+  return (mx >= endurance) ? 0 : endurance - mx;
+}
+
+void I2C_eeprom_wear::histogram(uint16_t *bins, const uint8_t binCount, const uint32_t binWidth)
+{
+  if (binCount == 0 || binWidth == 0) return;
+  memset(bins, 0, binCount * sizeof(uint16_t));
+  for (uint16_t g = 0; g < _groups; g++)
+  {
+    uint32_t bin = _counters[g] / binWidth;
+    if (bin >= binCount) bin = binCount - 1;
+    bins[bin]++;
+  }
+}
+
+uint8_t I2C_eeprom_wear::hotspots(uint16_t *groups, const uint8_t n)
+{
+  // insertion into the sorted top n, ties keep the lowest group first
+  uint8_t found = 0;
+  for (uint16_t g = 0; g < _groups; g++)
+  {
+    uint8_t i = found;
+    while (i > 0 && _counters[groups[i - 1]] < _counters[g])
+    {
+      if (i < n) groups[i] = groups[i - 1];
+      i--;
+    }
+    if (i < n)
+    {
+      groups[i] = g;
+      if (found < n) found++;
+    }
+  }
+  return found;
+}
+
+bool I2C_eeprom_wear::save()
+{
+  if (_eeprom == NULL || _slots == 0) return false;
+
+  uint16_t slot = (_slot + 1) % _slots;
+  uint32_t seq  = _seq + 1;
+  uint16_t addr = _slotAddress(slot);
+  uint16_t size = _groups * sizeof(uint32_t);
+
+  // the snapshot includes its own write cycles
+  _countRange(addr + I2C_EEPROM_WEAR_HEADER, size);
+  _countRange(addr, I2C_EEPROM_WEAR_HEADER);
+
+  uint8_t header[I2C_EEPROM_WEAR_HEADER];
+  memcpy(header, &seq, sizeof(seq));
+  header[4] = _crc8(_crc8(0, header, sizeof(seq)), (uint8_t *)_counters, size);
+
+  _eeprom->setWearMap(NULL);
+  bool ok = (_eeprom->writeBlock(addr + I2C_EEPROM_WEAR_HEADER, (uint8_t *)_counters, size) == 0)
+         && (_eeprom->writeBlock(addr, header, I2C_EEPROM_WEAR_HEADER) == 0);
+  _eeprom->setWearMap(this);
+  if (!ok) return false;
+
+  _slot    = slot;
+  _seq     = seq;
+  _unsaved = 0;
+  return true;
+}
+
+bool I2C_eeprom_wear::poll()
+{
+  if (_interval == 0 || _unsaved < _interval) return true;
+  return save();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// takes the snapshot with the highest seq that has a valid crc.
+bool I2C_eeprom_wear::_load()
+{
+  uint16_t size  = _groups * sizeof(uint32_t);
+  uint32_t limit = 0xFFFFFFFF;   // erased
+  while (true)
+  {
+    bool     found = false;
+    uint16_t best  = 0;
+    uint32_t bestSeq = 0;
+    for (uint16_t s = 0; s < _slots; s++)
+    {
+      uint32_t seq;
+      if (_eeprom->readBlock(_slotAddress(s), (uint8_t *)&seq, sizeof(seq)) != sizeof(seq)) return false;
+      if (seq < limit && (!found || seq > bestSeq))
+      {
+        found   = true;
+        best    = s;
+        bestSeq = seq;
+      }
+    }
+    if (!found) break;
+
+    uint8_t  header[I2C_EEPROM_WEAR_HEADER];
+    uint16_t addr = _slotAddress(best);
+    if ((_eeprom->readBlock(addr, header, I2C_EEPROM_WEAR_HEADER) == I2C_EEPROM_WEAR_HEADER)
+      && (_eeprom->readBlock(addr + I2C_EEPROM_WEAR_HEADER, (uint8_t *)_counters, size) == size)
+      && (_crc8(_crc8(0, header, sizeof(bestSeq)), (uint8_t *)_counters, size) == header[4]))
+    {
+      _slot = best;
+      _seq  = bestSeq;
+      _unsaved = 0;
+      return true;
+    }
+    limit = bestSeq;
+  }
+
+  // nothing saved yet, the first save() goes to slot 0 with seq 0
+  reset();
+  _slot = _slots - 1;
+  _seq  = 0xFFFFFFFF;
+  return false;
+}
+
+// counts the write transactions writeBlock() uses for a range.
+void I2C_eeprom_wear::_countRange(uint16_t memoryAddress, uint16_t length)
+{
+  while (length > 0)
+  {
+    uint8_t bytesUntilPageBoundary = _pageSize - memoryAddress % _pageSize;
+    uint8_t cnt = I2C_TWIBUFFERSIZE;
+    if (cnt > length) cnt = length;
+    if (cnt > bytesUntilPageBoundary) cnt = bytesUntilPageBoundary;
+    count(memoryAddress);
+    memoryAddress += cnt;
+    length -= cnt;
+  }
+}
+
+uint8_t I2C_eeprom_wear::_crc8(uint8_t crc, const uint8_t *data, const uint16_t length)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// -- END OF FILE --
@@ -0,0 +1,104 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_wear.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Per page write counting for I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// write cycles per page guaranteed by most 24LCxx datasheets
+#ifndef I2C_EEPROM_ENDURANCE
+#define I2C_EEPROM_ENDURANCE  1000000UL
+#endif
+
+class I2C_eeprom_wear
+{
+public:
+  /**
+    * Starts counting the write cycles of the eeprom.
+    *
+    * Every write transaction of the eeprom increments the counter of
+    * the group of pages it is in. With one group per page the count is
+    * exact, with fewer groups a counter is an upper bound for the
+    * write cycles of every page in its group.
+    *
+    * @param eeprom   The instance of I2C_eeprom to count.
+    * @param counters Buffer of the caller, one counter per group.
+    * @param groups   Number of groups, the pages are spread evenly over them.
+    * @return True if counting started, false otherwise.
+    */
+  bool     begin(I2C_eeprom &eeprom, uint32_t *counters, const uint16_t groups);
+
+  /**
+    * Like begin() above and loads the counters saved in pages
+    * firstPage .. firstPage + pages - 1 of the eeprom.
+    *
+    * The pages hold a ring of snapshots, save() writes the next one, so
+    * the storage is wear leveled itself. It needs room for two or more
+    * snapshots of 5 + 4 * groups bytes, each rounded up to whole pages.
+    *
+    * @return True if saved counters were loaded, false otherwise
+    * (counters start at zero).
+    */
+  bool     begin(I2C_eeprom &eeprom, uint32_t *counters, const uint16_t groups,
+                 const uint16_t firstPage, const uint16_t pages);
+
+  // stops counting.
+  void     end();
+
+  // called by I2C_eeprom for every write transaction.
+  void     count(const uint16_t memoryAddress);
+  // sets all counters to zero.
+  void     reset();
+
+  uint16_t getGroups()        { return _groups; };
+  uint16_t getPagesPerGroup() { return _pagesPerGroup; };
+  uint16_t getGroup(const uint16_t memoryAddress);
+  uint32_t getCount(const uint16_t group);
+  uint32_t getTotal();
+  uint32_t getMax();
+  // write cycles left for the most worn group.
+  uint32_t getRemaining(const uint32_t endurance = I2C_EEPROM_ENDURANCE);
+
+  // counts the groups per range of binWidth write cycles, bin i holds
+  // i * binWidth .. (i + 1) * binWidth - 1, the last bin all above.
+  void     histogram(uint16_t *bins, const uint8_t binCount, const uint32_t binWidth);
+  // fills groups with the n most worn groups, most worn first.
+  // returns the number of groups filled in.
+  uint8_t  hotspots(uint16_t *groups, const uint8_t n);
+
+  // writes a snapshot of the counters, only with storage.
+  bool     save();
+  // save() from poll() after this many counted writes, 0 = never (default).
+  void     setSaveInterval(const uint32_t writes) { _interval = writes; };
+  uint32_t getSaveInterval() { return _interval; };
+  // counted writes since the last save().
+  uint32_t getUnsaved()      { return _unsaved; };
+  // saves if the save interval has passed, returns false if that save failed.
+  bool     poll();
+
+private:
+  I2C_eeprom * _eeprom = NULL;
+  uint32_t * _counters;
+  uint16_t _groups;
+  uint16_t _pagesPerGroup;
+  uint8_t  _pageSize;
+  uint32_t _unsaved;
+  uint32_t _interval;
+
+  // storage, a ring of snapshots { seq, crc8, counters }
+  uint16_t _firstPage;
+  uint16_t _slots = 0;
+  uint16_t _slotPages;
+  uint16_t _slot;
+  uint32_t _seq;
+
+  bool     _load();
+  void     _countRange(uint16_t memoryAddress, uint16_t length);
+  uint16_t _slotAddress(const uint16_t slot) { return (_firstPage + slot * _slotPages) * _pageSize; };
+  uint8_t  _crc8(uint8_t crc, const uint8_t *data, const uint16_t length);
+};
+
+// -- END OF FILE --
@@ -0,0 +1,98 @@
+//
+//    FILE: I2C_eeprom_writer.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Page buffered Print on top of I2C_EEPROM library
+//
+// HISTORY:
+// 1.0.0    2026-10-18  initial version
+
+
+#include <I2C_eeprom_writer.h>
+
+
+I2C_eeprom_writer::I2C_eeprom_writer(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length)
+{
+  _eeprom      = &eeprom;
+  _end         = (uint32_t)memoryAddress + length;
+  _bufferStart = memoryAddress;
+  _fill        = 0;
+  _pageSize    = eeprom.getPageSize();
+  if (_pageSize > I2C_EEPROM_WRITER_BUFFER) _pageSize = I2C_EEPROM_WRITER_BUFFER;
+  _timeout     = 0;
+  _firstByte   = 0;
+  _error       = 0;
+}
+
+size_t I2C_eeprom_writer::write(uint8_t value)
+{
+  return write(&value, 1);
+}
+
+size_t I2C_eeprom_writer::write(const uint8_t *buffer, size_t size)
+{
+  poll();
+  size_t cnt = 0;
+  while (cnt < size)
+  {
+    if (position() >= _end) break;
+    // full page still buffered after a failed flush => retry first
+    if ((_fill != 0) && (position() % _pageSize == 0))
+    {
+      flush();
+      if (_error != 0) break;
+    }
+    if (_fill == 0) _firstByte = millis();
+
+    uint8_t room = _bytesUntilPageBoundary();
+    if (room > size - cnt) room = size - cnt;
+    if (room > _end - position()) room = _end - position();
+    memcpy(_buffer + _fill, buffer + cnt, room);
+    _fill += room;
+    cnt   += room;
+
+    // page complete => program it in one go
+    if (position() % _pageSize == 0)
+    {
+      flush();
+      if (_error != 0) break;
+    }
+  }
+  return cnt;
+}
+
+int I2C_eeprom_writer::availableForWrite()
+{
+  uint32_t rv = _end - position();
+  if (rv > 0x7FFF) rv = 0x7FFF;   // int is 16 bit on AVR
+  return rv;
+}
+
+void I2C_eeprom_writer::flush()
+{
+  if (_fill == 0) return;
+  _error = _eeprom->writeBlock(_bufferStart, _buffer, _fill);
+  if (_error != 0) return;   // keep data, caller can retry
+  _bufferStart += _fill;
+  _fill = 0;
+}
+
+void I2C_eeprom_writer::poll()
+{
+  if ((_timeout != 0) && (_fill != 0) && (millis() - _firstByte >= _timeout))
+  {
+    flush();
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+uint8_t I2C_eeprom_writer::_bytesUntilPageBoundary()
+{
+  return _pageSize - (position() % _pageSize);
+}
+
+// -- END OF FILE --
@@ -0,0 +1,69 @@
+#pragma once
+//
+//    FILE: I2C_eeprom_writer.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 1.0.0
+// PURPOSE: Page buffered Print on top of I2C_EEPROM library
+//
+
+#include <I2C_eeprom.h>
+
+// Size of the page buffer, must be a power of 2.
+// Pages larger than the buffer are written in buffer sized chunks.
+#ifndef I2C_EEPROM_WRITER_BUFFER
+#define I2C_EEPROM_WRITER_BUFFER I2C_EEPROM_PAGESIZE
+#endif
+
+class I2C_eeprom_writer : public Print
+{
+public:
+  /**
+    * Sequential writer over a region of the EEPROM.
+    *
+    * Bytes are collected until a page boundary is reached and then
+    * programmed with a single writeBlock(), so many small appends to
+    * one page cost one write cycle. writeBlock() splits a page in
+    * chunks of I2C_TWIBUFFERSIZE, on AVR (30 bytes) a 64 byte page
+    * still takes 3 write cycles.
+    *
+    * @param eeprom        The instance of I2C_eeprom to write to.
+    * @param memoryAddress Address of the first byte of the region.
+    * @param length        Number of bytes in the region.
+    */
+  I2C_eeprom_writer(I2C_eeprom &eeprom, const uint16_t memoryAddress, const uint16_t length);
+
+  // Print interface
+  size_t   write(uint8_t value);
+  size_t   write(const uint8_t *buffer, size_t size);
+  using    Print::write;
+  int      availableForWrite();
+  // programs the buffered bytes, if any.
+  void     flush();
+
+  // flushes a partially filled page if its first byte was buffered
+  // more than timeout milliseconds ago, 0 = disabled (default).
+  // the timeout is checked by write() and poll().
+  void     setFlushTimeout(const uint32_t timeout) { _timeout = timeout; };
+  uint32_t getFlushTimeout() { return _timeout; };
+  void     poll();
+
+  // next address to be written, including buffered bytes.
+  uint32_t position() { return _bufferStart + _fill; };
+  // returns the error code of the last failed flush, 0 = OK.
+  int      lastError() { return _error; };
+
+private:
+  I2C_eeprom * _eeprom;
+  uint32_t _end;            // one past last byte of region, 0x10000 at the top of a 64 KB device
+  uint32_t _bufferStart;    // address of _buffer[0]
+  uint8_t  _fill;           // bytes in _buffer
+  uint8_t  _pageSize;
+  uint32_t _timeout;
+  uint32_t _firstByte;      // millis() of first buffered byte
+  int      _error;
+  uint8_t  _buffer[I2C_EEPROM_WRITER_BUFFER];
+
+  uint8_t  _bytesUntilPageBoundary();
+};
+
+// -- END OF FILE --
@@ -63,6 +63,343 @@ unittest(test_constructor)
   assertEqual(1, 1);
 }
 
+unittest(test_default_device)
+{
+  I2C_eeprom EE(0x50);
+
+  assertEqual(64, EE.getPageSize());
+  assertEqual(I2C_DEVICESIZE_24LC256, EE.getDeviceSize());
+}
+
+unittest(test_page_size)
+{
+  I2C_eeprom EE01(0x50, I2C_DEVICESIZE_24LC01);
+  I2C_eeprom EE02(0x50, I2C_DEVICESIZE_24LC02);
+  I2C_eeprom EE04(0x50, I2C_DEVICESIZE_24LC04);
+  I2C_eeprom EE16(0x50, I2C_DEVICESIZE_24LC16);
+  I2C_eeprom EE32(0x50, I2C_DEVICESIZE_24LC32);
+  I2C_eeprom EE64(0x50, I2C_DEVICESIZE_24LC64);
+  I2C_eeprom EE128(0x50, I2C_DEVICESIZE_24LC128);
+  I2C_eeprom EE256(0x50, I2C_DEVICESIZE_24LC256);
+  I2C_eeprom EE512(0x50, I2C_DEVICESIZE_24LC512);
+
+  assertEqual(8, EE01.getPageSize());
+  assertEqual(8, EE02.getPageSize());
+  assertEqual(16, EE04.getPageSize());
+  assertEqual(16, EE16.getPageSize());
+  assertEqual(32, EE32.getPageSize());
+  assertEqual(32, EE64.getPageSize());
+  assertEqual(64, EE128.getPageSize());
+  assertEqual(64, EE256.getPageSize());
+  assertEqual(128, EE512.getPageSize());
+  assertEqual(I2C_DEVICESIZE_24LC512, EE512.getDeviceSize());
+}
+
+unittest(test_write_read_without_begin)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+  auto miso = Wire.getMiso(0x50);
+
+  // no begin(), the constructor prepares the ACK polling
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC32);
+
+  assertEqual(0, EE.writeByte(0x0102, 0x42));
+  miso->push_back(0x42);
+  assertEqual(0x42, EE.readByte(0x0102));
+  miso->push_back(0x43);
+  assertEqual(0x43, EE.readByte(0x0103));
+
+  // write, then two reads of 2 address bytes
+  assertEqual(3 + 2 + 2, mosi->size());
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0x02, (*mosi)[1]);
+  assertEqual(0x42, (*mosi)[2]);
+  assertEqual(0x03, (*mosi)[6]);
+  assertEqual(0, miso->size());
+}
+
+unittest(test_erase_skips_erased_pages)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC32);
+  EE.begin();
+
+  // first chunk already erased, second one not
+  for (int i = 0; i < 16; i++) miso->push_back(0xFF);
+  for (int i = 0; i < 16; i++) miso->push_back(0x00);
+
+  assertEqual(0, EE.erase(0x0010, 32));
+
+  // two compare reads, one write of 2 + 16 bytes
+  assertEqual(2 + 2 + 18, mosi->size());
+  assertEqual(0x20, (*mosi)[5]);
+  assertEqual(0xFF, (*mosi)[6]);
+}
+
+unittest(test_erase_past_64K)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+
+  // 128 KB, more than a 16 bit address reaches
+  I2C_eeprom EE(0x50, 131072UL);
+  EE.begin();
+
+  mosi->clear();
+  assertEqual(-1, EE.erase(0xFFF0, 32, 0x00));
+  assertEqual(-1, EE.erase(0x00));
+  assertEqual(-1, EE.setBlock(0xFFF0, 0x00, 32));
+  assertEqual(0, mosi->size());
+
+  // the last 16 bytes fit
+  assertEqual(0, EE.setBlock(0xFFF0, 0x00, 16));
+  assertEqual(2 + 16, mosi->size());
+  assertEqual(0xFF, (*mosi)[0]);
+  assertEqual(0xF0, (*mosi)[1]);
+}
+
+unittest(test_copy_to_other_device)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x51);
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom SRC(0x50, I2C_DEVICESIZE_24LC32);
+  I2C_eeprom DST(0x51, I2C_DEVICESIZE_24LC32);
+  SRC.begin();
+  DST.begin();
+
+  for (int i = 0; i < 4; i++) miso->push_back(i + 1);
+
+  assertEqual(0, SRC.copyBlock(0x0000, DST, 0x0123, 4));
+  assertEqual(6, mosi->size());
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0x23, (*mosi)[1]);
+  assertEqual(1, (*mosi)[2]);
+  assertEqual(4, (*mosi)[5]);
+
+  // source can not be read
+  assertEqual(-1, SRC.copyBlock(0x0000, DST, 0x0123, 4));
+}
+
+unittest(test_copy_overlap_backwards)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC32);
+  EE.begin();
+
+  // 0x0010 .. 0x0027 holds 1 .. 24, copied 8 bytes up
+  for (int i = 9; i <= 24; i++) miso->push_back(i);
+  for (int i = 1; i <= 8; i++) miso->push_back(i);
+
+  mosi->clear();
+  assertEqual(0, EE.copyBlock(0x0010, 0x0018, 24));
+  assertEqual(0, miso->size());
+  // the last chunk first, up to the page boundary at 0x0020,
+  // so no byte of the source is overwritten before it is read
+  assertEqual(2 + (2 + 16) + 2 + (2 + 8), mosi->size());
+  assertEqual(0x18, (*mosi)[1]);
+  assertEqual(0x20, (*mosi)[3]);
+  assertEqual(9, (*mosi)[4]);
+  assertEqual(24, (*mosi)[19]);
+  assertEqual(0x10, (*mosi)[21]);
+  assertEqual(0x18, (*mosi)[23]);
+  assertEqual(1, (*mosi)[24]);
+  assertEqual(8, (*mosi)[31]);
+}
+
+unittest(test_fram_no_page_split)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.begin();
+  uint8_t buffer[40];
+  memset(buffer, 0x11, sizeof(buffer));
+
+  // page boundary at 0x40 splits the write
+  assertEqual(false, EE.isFRAM());
+  assertEqual(0, EE.writeBlock(0x0030, buffer, 40));
+  assertEqual(2 + 16 + 2 + 24, mosi->size());
+  assertEqual(0x40, (*mosi)[19]);
+
+  // FRAM only splits at the TWI buffer
+  EE.setFRAM(true);
+  assertEqual(true, EE.isFRAM());
+  mosi->clear();
+  assertEqual(0, EE.writeBlock(0x0030, buffer, 40));
+  assertEqual(2 + I2C_TWIBUFFERSIZE + 2 + 40 - I2C_TWIBUFFERSIZE, mosi->size());
+  assertEqual(0x30 + I2C_TWIBUFFERSIZE, (*mosi)[2 + I2C_TWIBUFFERSIZE + 1]);
+}
+
+unittest(test_is_ready)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.begin();
+
+  // the poll adds no data to the bus
+  assertEqual(0, EE.writeByte(0x0010, 0x42));
+  mosi->clear();
+  assertEqual(true, EE.isReady());
+  assertEqual(true, EE.isReady());
+  assertEqual(0, mosi->size());
+
+  EE.setFRAM(true);
+  assertEqual(0, EE.writeByte(0x0010, 0x43));
+  assertEqual(true, EE.isReady());
+}
+
+unittest(test_fram_before_begin)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+
+  // begin() keeps the FRAM mode set before it
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.setFRAM(true);
+  EE.begin();
+  assertEqual(true, EE.isFRAM());
+  assertEqual(true, EE.isReady());
+  assertEqual(0, mosi->size());
+
+  uint8_t buffer[20];
+  memset(buffer, 0x22, sizeof(buffer));
+  assertEqual(0, EE.writeBlock(0x0038, buffer, 20));
+  assertEqual(2 + 20, mosi->size());
+}
+
+unittest(test_probe_clock)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.begin();
+  assertEqual(0, EE.getClock());
+
+  // same data at 1 MHz
+  for (int i = 0; i < 2 * I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(i % I2C_EEPROM_PROBE_SIZE);
+  assertEqual(I2C_EEPROM_CLOCK_1M, EE.probeClock());
+  assertEqual(I2C_EEPROM_CLOCK_1M, EE.getClock());
+  assertEqual(0, EE.getBusClock());
+
+  // garbled at 1 MHz, same at 400 KHz
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(i);
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(0xFF);
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(i);
+  EE.setClock(0, I2C_EEPROM_CLOCK_100K);
+  assertEqual(I2C_EEPROM_CLOCK_400K, EE.probeClock(0x0100));
+  assertEqual(I2C_EEPROM_CLOCK_400K, EE.getClock());
+  assertEqual(I2C_EEPROM_CLOCK_100K, EE.getBusClock());
+  assertEqual(0, miso->size());
+
+  // limited by maxClock, only the reference read
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(i);
+  assertEqual(I2C_EEPROM_CLOCK_100K, EE.probeClock(0, I2C_EEPROM_CLOCK_100K));
+
+  // no device, the clock is kept
+  assertEqual(0, EE.probeClock());
+  assertEqual(I2C_EEPROM_CLOCK_100K, EE.getClock());
+}
+
+unittest(test_probe_clock_erased)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.begin();
+
+  // erased, only the reference read and no write => 100 KHz
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(0xFF);
+  mosi->clear();
+  assertEqual(I2C_EEPROM_CLOCK_100K, EE.probeClock(0x0200));
+  assertEqual(2, mosi->size());
+  assertEqual(0, miso->size());
+
+  // scratch, the pattern is read back at 100 KHz and at 1 MHz
+  uint8_t pattern[I2C_EEPROM_PROBE_SIZE];
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) pattern[i] = 0xA5 + i * 0x3B;
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(pattern[i]);
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(pattern[i]);
+
+  mosi->clear();
+  assertEqual(I2C_EEPROM_CLOCK_1M, EE.probeClock(0x0200, I2C_EEPROM_CLOCK_1M, true));
+  assertEqual(0, miso->size());
+  // pattern written, two reads, the pattern is not removed
+  assertEqual((2 + I2C_EEPROM_PROBE_SIZE) + 2 + 2, mosi->size());
+  assertEqual(0x02, (*mosi)[0]);
+  assertEqual(0xA5, (*mosi)[2]);
+
+  // the pattern does not read back at 100 KHz => 100 KHz
+  for (int i = 0; i < I2C_EEPROM_PROBE_SIZE; i++) miso->push_back(0x00);
+  assertEqual(I2C_EEPROM_CLOCK_100K, EE.probeClock(0x0200, I2C_EEPROM_CLOCK_1M, true));
+  assertEqual(0, miso->size());
+}
+
+int holdCount = 0;
+void holdHook()
+{
+  holdCount++;
+}
+
+unittest(test_bus_hold)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(0x50);
+  auto miso = Wire.getMiso(0x50);
+
+  I2C_eeprom EE(0x50, I2C_DEVICESIZE_24LC256);
+  EE.begin();
+  uint8_t buffer[3 * I2C_TWIBUFFERSIZE];
+  for (int i = 0; i < 40 + 2 * I2C_TWIBUFFERSIZE; i++) miso->push_back(i);
+
+  // no budget, no hook
+  holdCount = 0;
+  EE.setBusHold(0, 0, holdHook);
+  assertEqual(40, EE.readBlock(0, buffer, 40));
+  assertEqual(0, holdCount);
+
+  // at most 2 TWI buffers per hold, the budget restarts every call
+  EE.setBusHold(2 * I2C_TWIBUFFERSIZE, 0, holdHook);
+  assertEqual(2 * I2C_TWIBUFFERSIZE, EE.readBlock(0, buffer, 2 * I2C_TWIBUFFERSIZE));
+  assertEqual(0, holdCount);
+  for (int i = 0; i < 3 * I2C_TWIBUFFERSIZE; i++) miso->push_back(i);
+  assertEqual(3 * I2C_TWIBUFFERSIZE, EE.readBlock(0, buffer, 3 * I2C_TWIBUFFERSIZE));
+  assertEqual(1, holdCount);
+
+  // a yield between every page chunk of a write
+  holdCount = 0;
+  EE.setBusHold(1, 0, holdHook);
+  mosi->clear();
+  memset(buffer, 0, sizeof(buffer));
+  assertEqual(0, EE.writeBlock(0x0030, buffer, 40));
+  assertEqual(1, holdCount);
+}
+
 unittest_main()
 
 // --------
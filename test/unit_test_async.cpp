@@ -0,0 +1,175 @@
+//
+//    FILE: unit_test_async.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the coroutine interface of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+// the tests need a C++20 compiler, e.g. -std=c++20, they are empty otherwise.
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_async.h"
+
+#ifdef I2C_EEPROM_COROUTINES
+
+// Simulated 24LC32, busy for 5 ms after every write.
+struct SimEEPROM
+{
+  uint8_t  memory[4096];
+  uint32_t busyUntil = 0;
+  int      writes = 0;
+  int      crossings = 0;    // writes over a page boundary
+  int      sensorAtWrite[8];
+  int      * sensor = NULL;
+
+  bool     isReady()     { return (int32_t)(micros() - busyUntil) >= 0; };
+  bool     isFRAM()      { return false; };
+  uint8_t  getPageSize() { return 32; };
+
+  int writeBlock(uint16_t memoryAddress, const uint8_t *buffer, uint16_t length)
+  {
+    if (!isReady()) return 4;
+    if (memoryAddress / 32 != (memoryAddress + length - 1) / 32) crossings++;
+    memcpy(memory + memoryAddress, buffer, length);
+    if (writes < 8) sensorAtWrite[writes] = sensor ? *sensor : 0;
+    writes++;
+    busyUntil = micros() + 5000;
+    return 0;
+  };
+
+  uint16_t readBlock(uint16_t memoryAddress, uint8_t *buffer, uint16_t length)
+  {
+    if (!isReady()) return 0;
+    memcpy(buffer, memory + memoryAddress, length);
+    return length;
+  };
+};
+
+int sensorCount = 0;
+
+I2C_eeprom_op sensorTask(I2C_eeprom_executor &executor, int samples)
+{
+  for (int i = 0; i < samples; i++)
+  {
+    sensorCount++;
+    co_await executor.yield();
+  }
+  co_return samples;
+}
+
+I2C_eeprom_op roundTrip(I2C_eeprom_async<SimEEPROM> &async, const uint8_t *data, uint8_t *buffer)
+{
+  int rv = co_await async.writeBlock(0x100, data, 8);
+  if (rv != 0) co_return -1;
+  co_return co_await async.readBlock(0x100, buffer, 8);
+}
+
+void runAll(I2C_eeprom_executor &executor)
+{
+  while (executor.poll()) delayMicroseconds(500);
+}
+
+#endif
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that a write is split at the page boundary and that
+ * other coroutines run during the write cycle.
+ */
+unittest(async_write_interleave)
+{
+#ifdef I2C_EEPROM_COROUTINES
+  SimEEPROM EE;
+  memset(EE.memory, 0xFF, sizeof(EE.memory));
+  sensorCount = 0;
+  EE.sensor = &sensorCount;
+
+  I2C_eeprom_executor executor;
+  I2C_eeprom_async<SimEEPROM> async(EE, executor);
+
+  uint8_t data[40];
+  for (int i = 0; i < 40; i++) data[i] = i;
+  int writeResult = -1;
+  int sensorResult = -1;
+  assertEqual(true, executor.spawn(async.writeBlock(0x10, data, 40), &writeResult));
+  assertEqual(true, executor.spawn(sensorTask(executor, 20), &sensorResult));
+  assertEqual(2, executor.count());
+
+  runAll(executor);
+  assertEqual(0, executor.count());
+  assertEqual(0, writeResult);
+  assertEqual(20, sensorResult);
+
+  // 16 bytes to the end of page 0, 24 bytes in page 1
+  assertEqual(2, EE.writes);
+  assertEqual(0, EE.crossings);
+  assertEqual(0, memcmp(EE.memory + 0x10, data, 40));
+  // the sensor ran during the write cycle
+  assertLess(EE.sensorAtWrite[0], EE.sensorAtWrite[1]);
+#endif
+}
+
+/**
+ * Verify that operations can be awaited
+ * and return their result.
+ */
+unittest(async_round_trip)
+{
+#ifdef I2C_EEPROM_COROUTINES
+  SimEEPROM EE;
+  memset(EE.memory, 0xFF, sizeof(EE.memory));
+
+  I2C_eeprom_executor executor;
+  I2C_eeprom_async<SimEEPROM> async(EE, executor);
+
+  uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  uint8_t buffer[8];
+  int result = -1;
+  executor.spawn(roundTrip(async, data, buffer), &result);
+  runAll(executor);
+  assertEqual(8, result);
+  assertEqual(0, memcmp(data, buffer, 8));
+
+  // no write when the data is the same
+  executor.spawn(async.updateBlock(0x100, data, 8), &result);
+  runAll(executor);
+  assertEqual(0, result);
+  assertEqual(1, EE.writes);
+#endif
+}
+
+/**
+ * Verify sleep() and the limit on operations.
+ */
+unittest(async_executor)
+{
+#ifdef I2C_EEPROM_COROUTINES
+  I2C_eeprom_executor executor;
+  for (int i = 0; i < I2C_EEPROM_EXECUTOR_TASKS; i++)
+  {
+    assertEqual(true, executor.spawn(sensorTask(executor, 1)));
+  }
+  assertEqual(false, executor.spawn(sensorTask(executor, 1)));
+  executor.run();
+  assertEqual(0, executor.count());
+
+  uint32_t start = millis();
+  executor.spawn(executor.sleep(10));
+  runAll(executor);
+  assertMoreOrEqual(millis() - start, 10);
+#endif
+}
+
+unittest_main()
+
+// --------
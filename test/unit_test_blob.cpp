@@ -0,0 +1,134 @@
+//
+//    FILE: unit_test_blob.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the compressed tables of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_blob.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify the encoding of the differences and that
+ * the header is written after the data.
+ */
+unittest(blob_write)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_blob_writer BW(EE, 0x100, 64);
+  assertEqual(true, BW.begin());
+  // header invalidated first
+  assertEqual(4, mosi->size());
+  assertEqual(0xFF, (*mosi)[2]);
+  assertEqual(0xFF, (*mosi)[3]);
+
+  int16_t values[5] = { 1000, 1001, 1003, 1002, -5 };
+  mosi->clear();
+  assertEqual(5, BW.write(values, 5));
+  assertEqual(0, mosi->size());
+  assertEqual(5, BW.count());
+  assertEqual(7, BW.size());
+  assertEqual(0, BW.end());
+
+  // data at 0x104
+  assertEqual(2 + 7 + 2 + 4, mosi->size());
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0x04, (*mosi)[1]);
+  assertEqual(0xD0, (*mosi)[2]);    // 1000 => 2000
+  assertEqual(0x0F, (*mosi)[3]);
+  assertEqual(0x02, (*mosi)[4]);    // +1
+  assertEqual(0x04, (*mosi)[5]);    // +2
+  assertEqual(0x01, (*mosi)[6]);    // -1
+  assertEqual(0xDD, (*mosi)[7]);    // -1007 => 2013
+  assertEqual(0x0F, (*mosi)[8]);
+  // header { 5, 7 } at 0x100
+  assertEqual(0x01, (*mosi)[9]);
+  assertEqual(0x00, (*mosi)[10]);
+  assertEqual(5, (*mosi)[11]);
+  assertEqual(7, (*mosi)[13]);
+}
+
+/**
+ * Verify that a value that does not fit is not stored.
+ */
+unittest(blob_full)
+{
+  Wire.resetMocks();
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_blob_writer BW(EE, 0x100, 8);
+  BW.begin();
+  int16_t values[3] = { 1, 2, 10000 };
+  assertEqual(2, BW.write(values, 3));
+  assertEqual(0, BW.write(3));
+  assertEqual(2, BW.count());
+  assertEqual(-1, BW.end());
+}
+
+/**
+ * Verify that the reader decodes the values
+ * with one bus read per window.
+ */
+unittest(blob_read)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t image[4 + 7] = { 5, 0, 7, 0, 0xD0, 0x0F, 0x02, 0x04, 0x01, 0xDD, 0x0F };
+  for (int i = 0; i < 4; i++) miso->push_back(image[i]);
+  // window of I2C_EEPROM_READAHEAD bytes
+  for (int i = 4; i < 11; i++) miso->push_back(image[i]);
+  for (int i = 11; i < 4 + I2C_EEPROM_READAHEAD; i++) miso->push_back(0xFF);
+
+  I2C_eeprom_blob_reader BR(EE, 0x100, 64);
+  assertEqual(true, BR.begin());
+  assertEqual(5, BR.count());
+  assertEqual(7, BR.size());
+
+  int16_t values[8];
+  mosi->clear();
+  assertEqual(5, BR.read(values, 8));
+  assertEqual(2, mosi->size());
+  assertEqual(1000, values[0]);
+  assertEqual(1001, values[1]);
+  assertEqual(1003, values[2]);
+  assertEqual(1002, values[3]);
+  assertEqual(-5, values[4]);
+  assertEqual(0, BR.available());
+
+  // a blank region holds no table
+  for (int i = 0; i < 4; i++) miso->push_back(0xFF);
+  assertEqual(false, BR.begin());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,410 @@
+//
+//    FILE: unit_test_btree.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_btree class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_btree.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+// 4 byte values => 3 records per leaf, 4 keys per inner node
+// tree at page 0, nodes from page 1
+uint8_t cache[4 * 32];
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+// first page { "EEBT", root, nextFree, height, valueSize, split, crc }
+void pushMeta(std::deque<uint8_t> *miso, uint8_t root, uint8_t nextFree, uint8_t height, uint8_t split = 0)
+{
+  uint8_t meta[12] = { 'E', 'E', 'B', 'T', root, 0, nextFree, 0, height, 4, split, 0 };
+  uint8_t crc = 0;
+  for (int i = 0; i < 11; i++)
+  {
+    crc ^= meta[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  meta[11] = crc;
+  for (int i = 0; i < 12; i++) miso->push_back(meta[i]);
+}
+
+// node of 30 bytes, the TWI buffer, keys and values / children of one byte
+void pushNode(std::deque<uint8_t> *miso, uint8_t leaf, uint8_t count, uint8_t next, const uint8_t *keys, const uint8_t *values)
+{
+  int n = 0;
+  miso->push_back(leaf);
+  miso->push_back(count);
+  miso->push_back(next);
+  miso->push_back(next == 0xFF ? 0xFF : 0);
+  n += 4;
+  for (int i = 0; i < count; i++)
+  {
+    miso->push_back(keys[i]);
+    for (int b = 0; b < 3; b++) miso->push_back(0);
+    miso->push_back(values[i]);
+    miso->push_back(0);
+    n += 6;
+    if (leaf)
+    {
+      for (int b = 0; b < 2; b++) miso->push_back(0);
+      n += 2;
+    }
+  }
+  for (; n < 30; n++) miso->push_back(0xFF);
+}
+
+/**
+ * Verify that begin() finds no tree on a blank eeprom,
+ * format() writes one and begin() finds that one.
+ */
+unittest(btree_begin_format)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_btree T;
+  assertEqual(false, T.begin(EE, cache, 4, 0, 128, 40));
+  assertEqual(false, T.begin(EE, cache, 9, 0, 128, 4));
+  assertEqual(false, T.begin(EE, NULL, 4, 0, 128, 4));
+
+  for (int i = 0; i < 12; i++) miso->push_back(0xFF);
+  assertEqual(false, T.begin(EE, cache, 4, 0, 128, 4));
+  assertEqual(3, T.getLeafSlots());
+  assertEqual(4, T.getInnerSlots());
+
+  mosi->clear();
+  assertEqual(true, T.format());
+  // empty root leaf at page 1, then the first page
+  assertEqual(6 + 14, mosi->size());
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual(1, (*mosi)[2]);
+  assertEqual(0, (*mosi)[3]);
+  assertEqual(0x00, (*mosi)[7]);
+  assertEqual('E', (*mosi)[8]);
+  assertEqual('T', (*mosi)[11]);
+  assertEqual(1, (*mosi)[12]);
+  assertEqual(2, (*mosi)[14]);
+
+  for (int i = 8; i < 20; i++) miso->push_back((*mosi)[i]);
+  assertEqual(true, T.begin(EE, cache, 4, 0, 128, 4));
+  assertEqual(1, T.getHeight());
+  assertEqual(2, T.getUsedPages());
+  assertEqual(126, T.getFreePages());
+
+  // other value size
+  pushMeta(miso, 1, 2, 1);
+  assertEqual(false, T.begin(EE, cache, 4, 0, 128, 8));
+}
+
+/**
+ * Verify that records are kept sorted, a full leaf splits
+ * and the cache saves all reads.
+ */
+unittest(btree_insert_split)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_btree T;
+  T.begin(EE, cache, 4, 0, 128, 4);
+  T.format();
+
+  uint32_t value = 200;
+  assertEqual(0, T.insert(20, &value));
+  value = 300;
+  assertEqual(0, T.insert(30, &value));
+  value = 100;
+  mosi->clear();
+  assertEqual(0, T.insert(10, &value));
+  // one write of the leaf
+  assertEqual(2 + 4 + 3 * 8, mosi->size());
+  assertEqual(3, (*mosi)[3]);
+  assertEqual(10, (*mosi)[6]);
+  assertEqual(100, (*mosi)[10]);
+  assertEqual(20, (*mosi)[14]);
+
+  // split in the middle, new root
+  value = 150;
+  mosi->clear();
+  assertEqual(0, T.insert(15, &value));
+  assertEqual(14 + (2 + 4 + 16) + (2 + 4 + 16) + (2 + 4 + 6) + 14, mosi->size());
+  assertEqual(2, T.getHeight());
+  assertEqual(4, T.getUsedPages());
+  // split flag set before, cleared with the new root
+  assertEqual(1, (*mosi)[12]);
+  assertEqual(0, (*mosi)[72 + 12]);
+  // new leaf { 20, 30 } at page 2
+  assertEqual(0x40, (*mosi)[15]);
+  assertEqual(2, (*mosi)[17]);
+  assertEqual(20, (*mosi)[20]);
+  // leaf { 10, 15 } points to it
+  assertEqual(0x20, (*mosi)[37]);
+  assertEqual(2, (*mosi)[39]);
+  assertEqual(2, (*mosi)[40]);
+  // root at page 3 { child 1, 20, child 2 }
+  assertEqual(0x60, (*mosi)[59]);
+  assertEqual(1, (*mosi)[62]);
+  assertEqual(20, (*mosi)[64]);
+  assertEqual(2, (*mosi)[68]);
+
+  mosi->clear();
+  assertEqual(true, T.find(15, &value));
+  assertEqual(150, value);
+  assertEqual(false, T.find(25, &value));
+  assertEqual(0, T.getNodeReads());
+  assertEqual(0, mosi->size());
+  assertEqual(0, miso->size());
+}
+
+/**
+ * Verify that seek() and next() return a range in key order.
+ */
+unittest(btree_range)
+{
+  Wire.resetMocks();
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_btree T;
+  T.begin(EE, cache, 4, 0, 128, 4);
+  T.format();
+
+  uint32_t keys[6] = { 50, 10, 40, 20, 60, 30 };
+  for (int i = 0; i < 6; i++)
+  {
+    uint32_t value = keys[i] * 10;
+    assertEqual(0, T.insert(keys[i], &value));
+  }
+
+  uint32_t key;
+  uint32_t value;
+  uint32_t expect = 10;
+  assertEqual(true, T.seek(0));
+  while (T.next(key, &value))
+  {
+    assertEqual(expect, key);
+    assertEqual(expect * 10, value);
+    expect += 10;
+  }
+  assertEqual(70, expect);
+
+  assertEqual(true, T.seek(25, 50));
+  assertEqual(true, T.next(key, &value));
+  assertEqual(30, key);
+  assertEqual(true, T.next(key, &value));
+  assertEqual(40, key);
+  assertEqual(true, T.next(key, &value));
+  assertEqual(50, key);
+  assertEqual(false, T.next(key, &value));
+  assertEqual(0, T.getNodeReads());
+}
+
+/**
+ * Verify that ascending keys fill the left leaf
+ * and that without cache every level is read.
+ */
+unittest(btree_append_no_cache)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_btree T;
+  T.begin(EE, cache, 4, 0, 128, 4);
+  T.format();
+  uint32_t value = 0;
+  for (uint32_t k = 1; k <= 3; k++) T.insert(k, &value);
+  mosi->clear();
+  assertEqual(0, T.insert(4, &value));
+  // new leaf { 4 }, leaf { 1, 2, 3 }
+  assertEqual(1, (*mosi)[17]);
+  assertEqual(3, (*mosi)[31]);
+  assertEqual(2, (*mosi)[32]);
+
+  // root at page 3 { child 1, 4, child 2 } from the eeprom
+  uint8_t rootKeys[1]   = { 4 };
+  uint8_t rootChilds[1] = { 2 };
+  uint8_t leafKeys[1]   = { 4 };
+  uint8_t leafValues[1] = { 44 };
+  pushMeta(miso, 3, 4, 2);
+  assertEqual(true, T.begin(EE, NULL, 0, 0, 128, 4));
+  assertEqual(2, T.getHeight());
+
+  pushNode(miso, 0, 1, 1, rootKeys, rootChilds);
+  pushNode(miso, 1, 1, 0xFF, leafKeys, leafValues);
+  mosi->clear();
+  assertEqual(true, T.find(4, &value));
+  assertEqual(44, value);
+  assertEqual(2, T.getNodeReads());
+  // root read, then the leaf, one transaction of a 30 byte node each
+  assertEqual(2 + 2, mosi->size());
+  assertEqual(0x60, (*mosi)[1]);
+  assertEqual(0x40, (*mosi)[3]);
+  assertEqual(0, miso->size());
+}
+
+/**
+ * Verify that without cache next() reads the header
+ * of a leaf once and then only one record per call.
+ */
+unittest(btree_range_no_cache)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // root at page 3 { child 1, 4, child 2 }, leaves { 1, 2, 3 } and { 4 }
+  uint8_t rootKeys[1]   = { 4 };
+  uint8_t rootChilds[1] = { 2 };
+  uint8_t leafKeys[3]   = { 1, 2, 3 };
+  uint8_t leafValues[3] = { 11, 22, 33 };
+  pushMeta(miso, 3, 4, 2);
+  I2C_eeprom_btree T;
+  assertEqual(true, T.begin(EE, NULL, 0, 0, 128, 4));
+
+  pushNode(miso, 0, 1, 1, rootKeys, rootChilds);
+  pushNode(miso, 1, 3, 2, leafKeys, leafValues);
+  assertEqual(true, T.seek(2));
+  assertEqual(2, T.getNodeReads());
+
+  // records { key, value } of 8 bytes, the header of leaf 2 in between
+  uint8_t records[3][8] = { { 2, 0, 0, 0, 22, 0, 0, 0 }, { 3, 0, 0, 0, 33, 0, 0, 0 }, { 4, 0, 0, 0, 44, 0, 0, 0 } };
+  uint8_t header[4] = { 1, 1, 0xFF, 0xFF };
+  for (int i = 0; i < 8; i++) miso->push_back(records[0][i]);
+  for (int i = 0; i < 8; i++) miso->push_back(records[1][i]);
+  for (int i = 0; i < 4; i++) miso->push_back(header[i]);
+  for (int i = 0; i < 8; i++) miso->push_back(records[2][i]);
+
+  mosi->clear();
+  uint32_t key;
+  uint32_t value;
+  for (uint32_t k = 2; k <= 4; k++)
+  {
+    assertEqual(true, T.next(key, &value));
+    assertEqual(k, key);
+    assertEqual(k * 11, value);
+  }
+  assertEqual(false, T.next(key, &value));
+  assertEqual(0, miso->size());
+  // only the header of leaf 2 is a node read
+  assertEqual(3, T.getNodeReads());
+  assertEqual(4 * 2, mosi->size());
+  assertEqual(0x2C, (*mosi)[1]);
+  assertEqual(0x34, (*mosi)[3]);
+  assertEqual(0x40, (*mosi)[5]);
+  assertEqual(0x44, (*mosi)[7]);
+}
+
+/**
+ * Verify that begin() completes a split of which
+ * the parent was not written before a reset.
+ */
+unittest(btree_repair)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // root leaf { 10, 15 } split, leaf { 20, 30 } at page 2 but no new root
+  uint8_t leftKeys[2]    = { 10, 15 };
+  uint8_t leftValues[2]  = { 100, 150 };
+  uint8_t rightKeys[2]   = { 20, 30 };
+  uint8_t rightValues[2] = { 200, 44 };
+  pushMeta(miso, 1, 3, 1, 1);
+  pushNode(miso, 1, 2, 2, leftKeys, leftValues);
+  pushNode(miso, 1, 2, 0xFF, rightKeys, rightValues);
+
+  mosi->clear();
+  I2C_eeprom_btree T;
+  assertEqual(true, T.begin(EE, cache, 4, 0, 128, 4));
+  assertEqual(0, miso->size());
+  assertEqual(2, T.getHeight());
+  assertEqual(4, T.getUsedPages());
+  // meta and two leaves read, root at page 3 { child 1, 20, child 2 }
+  assertEqual(2 + 2 + 2 + (2 + 4 + 6) + 14 + 14, mosi->size());
+  assertEqual(0x60, (*mosi)[7]);
+  assertEqual(1, (*mosi)[10]);
+  assertEqual(20, (*mosi)[12]);
+  assertEqual(2, (*mosi)[16]);
+  // split flag cleared by the last write
+  assertEqual(1, (*mosi)[18 + 12]);
+  assertEqual(0, (*mosi)[32 + 12]);
+
+  uint32_t value;
+  assertEqual(true, T.find(30, &value));
+  assertEqual(44, value);
+  assertEqual(2, T.getNodeReads());
+}
+
+/**
+ * Verify that on a 64 byte page a node is capped at the TWI
+ * buffer, so a write can not fail in the middle of a node.
+ */
+unittest(btree_node_one_transaction)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_DEVICESIZE_24LC128);
+  EE.begin();
+  assertEqual(64, EE.getPageSize());
+
+  uint8_t pages[2 * 64];
+  I2C_eeprom_btree T;
+  T.begin(EE, pages, 2, 0, 128, 4);
+  // (30 - 4) / 8, not (64 - 4) / 8
+  assertEqual(3, T.getLeafSlots());
+  assertEqual(4, T.getInnerSlots());
+  T.format();
+
+  uint32_t value = 0;
+  for (uint32_t k = 1; k <= 2; k++) T.insert(k, &value);
+  mosi->clear();
+  assertEqual(0, T.insert(3, &value));
+  // full leaf at page 1 in one chunk, at most the TWI buffer
+  assertEqual(2 + 4 + 3 * 8, mosi->size());
+  assertMoreOrEqual(2 + I2C_TWIBUFFERSIZE, mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x40, (*mosi)[1]);
+}
+
+unittest_main()
+
+// --------
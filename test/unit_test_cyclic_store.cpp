@@ -6,17 +6,9 @@
 //          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
 //
 
-// Note: The implementation of the I2C_eeprom_cyclic_store should have been
-// made injactable so that a mock or fake for I2C_eeprom could have been used
-// instead of having to rely on a test implementation of the Wire singleton.
-// 
-// This could have been done by changing the class to take two template
-// parameters, the first being one for I2C_eeprom or it's mock and the second
-// being the data type to store. For simplicity an alias could have been
-// introduced so that users wouldn't have to specify I2C_eeprom but that made
-// the editor lose track of the intellisense comments. :-/ 
-//
-// Thus this remains until someone comes up with a brighter idea.
+// Note: Most tests rely on the test implementation of the Wire singleton.
+// The power cut tests use the second template parameter of
+// I2C_eeprom_cyclic_store to inject a fake eeprom instead.
 
 #include <ArduinoUnitTests.h>
 
@@ -712,6 +704,347 @@ unittest(cyclic_store_wrapping_double_page_odd_space)
   mosi->pop_front();
 }
 
+/**
+ * Check that the format() call of I2C_eeprom_cyclic_store
+ * writes to the correct places when the region does not
+ * start at the first page.
+ */
+unittest(cyclic_store_format_first_page)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_cyclic_store<uint8_t[20]> CS;
+  CS.begin(EE, 32, 2, 10);
+
+  mosi->clear();
+
+  CS.format();
+
+  // It should write exactly 12 bytes to the eeprom
+  assertEqual(12, mosi->size());
+
+  // Check that it writes empty marker to 320 and 352
+  uint8_t expected[12] = {1,64,0xff,0xff,0xff,0xff,1,96,0xff,0xff,0xff,0xff};
+
+  for(int i = 0; i < 12; i++)
+  {
+    assertEqual(expected[i], mosi->front());
+    mosi->pop_front();
+  }
+}
+
+/**
+ * Check that in delta mode a small change is appended as
+ * a delta record instead of writing a full new version.
+ */
+unittest(cyclic_store_delta_record)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+
+  uint8_t shadow[24];
+  uint8_t data[24] = {0};
+
+  I2C_eeprom_cyclic_store<uint8_t[24]> CS;
+  CS.enableDelta(shadow, 1);
+  assertEqual(true, CS.begin(EE, 32, 4));
+
+  // full version + delta page per slot => 2 slots
+  uint16_t slots;
+  uint32_t writes;
+  CS.getMetrics(slots, writes);
+  assertEqual(2, slots);
+
+  mosi->clear();
+  CS.write(data);
+  // It should write addr + header + buffer
+  assertEqual(30, mosi->size());
+
+  mosi->clear();
+  data[5] = 42;
+  CS.write(data);
+  // It should write addr + record { version, size, offset, length, 1 byte, crc }
+  assertEqual(13, mosi->size());
+  assertEqual(0, (*mosi)[0]);
+  assertEqual(32, (*mosi)[1]);
+  assertEqual(5, (*mosi)[8]);
+  assertEqual(42, (*mosi)[11]);
+
+  // No new version was written
+  CS.getMetrics(slots, writes);
+  assertEqual(1, writes);
+
+  uint8_t result[24];
+  assertEqual(true, CS.read(result));
+  assertEqual(42, result[5]);
+}
+
+/**
+ * Check that in delta mode a full version is written
+ * when the shadow copy could not be read.
+ */
+unittest(cyclic_store_delta_after_failed_read)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+
+  uint8_t shadow[24];
+  uint8_t data[24] = {0};
+
+  I2C_eeprom_cyclic_store<uint8_t[24]> CS;
+  CS.enableDelta(shadow, 1);
+  assertEqual(true, CS.begin(EE, 32, 4));
+
+  // version 0 in slot 0, all bytes changed => version 1 in slot 1
+  CS.write(data);
+  memset(data, 1, sizeof(data));
+  CS.write(data);
+  assertEqual(1, CS.getVersion());
+
+  // the header of slot 0 is read, its data is not
+  miso->push_back(0);
+  miso->push_back(0);
+  miso->push_back(0);
+  miso->push_back(0);
+  assertEqual(false, CS.revert(0));
+  assertEqual(0, miso->size());
+
+  mosi->clear();
+  data[5] = 42;
+  CS.write(data);
+  // It should write a full version to slot 1
+  assertEqual(30, mosi->size());
+  assertEqual(0, (*mosi)[0]);
+  assertEqual(64, (*mosi)[1]);
+
+  mosi->clear();
+  data[6] = 43;
+  CS.write(data);
+  // It should write a delta record at the start of the delta page of slot 1
+  assertEqual(13, mosi->size());
+  assertEqual(96, (*mosi)[1]);
+}
+
+/**
+ * Check that with a cache read() only accesses the
+ * eeprom once and returns the written data afterwards.
+ */
+unittest(cyclic_store_cached_read)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+  uint32_t tmp = 0;
+  miso->push_back(((uint8_t*)&tmp)[0]);
+  miso->push_back(((uint8_t*)&tmp)[1]);
+  miso->push_back(((uint8_t*)&tmp)[2]);
+  miso->push_back(((uint8_t*)&tmp)[3]);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  miso->push_back(0xff);
+  // data of slot 0
+  miso->push_back(17);
+
+  DummyTestData cache;
+  DummyTestData data;
+
+  I2C_eeprom_cyclic_store<DummyTestData> CS;
+  CS.enableCache(cache);
+  assertEqual(true, CS.begin(EE, 32, 4));
+
+  mosi->clear();
+  assertEqual(true, CS.read(data));
+  assertEqual(17, data.padding);
+  assertEqual(2, mosi->size());
+
+  mosi->clear();
+  data.padding = 0;
+  assertEqual(true, CS.read(data));
+  assertEqual(17, data.padding);
+  assertEqual(0, mosi->size());
+
+  data.padding = 33;
+  CS.write(data);
+  mosi->clear();
+  data.padding = 0;
+  assertEqual(true, CS.read(data));
+  assertEqual(33, data.padding);
+  assertEqual(0, mosi->size());
+}
+
+/**
+ * Verify that I2C_eeprom_cyclic_store reads the headers
+ * of small slots in a single transaction.
+ */
+unittest(cyclic_store_batched_header_read)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  // headers of slot 0, 1, 2 and 3, 8 bytes apart
+  uint8_t image[28];
+  memset(image, 0xff, sizeof(image));
+  uint32_t tmp = 0;
+  memcpy(image, &tmp, 4);
+  tmp = 1;
+  memcpy(image + 8, &tmp, 4);
+  for (int i = 0; i < 28; i++) miso->push_back(image[i]);
+
+  I2C_eeprom_cyclic_store<DummyTestData> CS;
+  assertEqual(true, CS.begin(EE, 8, 16));
+
+  uint16_t slots;
+  uint32_t writes;
+  CS.getMetrics(slots, writes);
+  assertEqual(16, slots);
+  assertEqual(2, writes);
+
+  uint32_t duration;
+  uint16_t reads;
+  CS.getMountMetrics(duration, reads);
+  assertEqual(1, reads);
+  assertEqual(2, mosi->size());
+}
+
+/**
+ * Fake eeprom that splits writes like I2C_eeprom does, at page
+ * boundaries and at the TWI buffer size, and cuts the power after
+ * a given number of write transactions.
+ */
+class PowerCutEEPROM
+{
+public:
+  uint8_t memory[I2C_EEPROM_SIZE];
+  int cutAfter = -1;
+  int transactions = 0;
+
+  PowerCutEEPROM() { memset(memory, 0xff, sizeof(memory)); }
+
+  void powerOn() { cutAfter = -1; transactions = 0; }
+
+  int writeBlock(const uint16_t memoryAddress, const uint8_t *buffer, const uint16_t length)
+  {
+    uint16_t addr = memoryAddress;
+    uint16_t len = length;
+    while (len > 0)
+    {
+      uint16_t cnt = len < I2C_TWIBUFFERSIZE ? len : I2C_TWIBUFFERSIZE;
+      uint16_t rest = 32 - addr % 32;
+      if (cnt > rest) cnt = rest;
+      if (cutAfter >= 0 && transactions >= cutAfter) return 4;
+      memcpy(memory + addr, buffer, cnt);
+      transactions++;
+      addr += cnt;
+      buffer += cnt;
+      len -= cnt;
+    }
+    return 0;
+  }
+
+  uint16_t readBlock(const uint16_t memoryAddress, uint8_t *buffer, const uint16_t length)
+  {
+    memcpy(buffer, memory + memoryAddress, length);
+    return length;
+  }
+
+  int erase(const uint16_t memoryAddress, const uint16_t length)
+  {
+    memset(memory + memoryAddress, 0xff, length);
+    return 0;
+  }
+};
+
+struct LargeTestData {
+  uint8_t bytes[100];
+};
+
+/**
+ * Write a new value with a power cut after each write transaction
+ * and return the number of cuts that left a mix of old and new data.
+ */
+int countTornWrites(bool headerLast)
+{
+  int torn = 0;
+  for (int cut = 0; cut <= 8; cut++)
+  {
+    PowerCutEEPROM EE;
+    LargeTestData data;
+
+    I2C_eeprom_cyclic_store<LargeTestData, PowerCutEEPROM> CS;
+    CS.begin(EE, 32, 32);
+    CS.setHeaderLast(headerLast);
+    CS.format();
+    memset(data.bytes, 0x11, sizeof(data.bytes));
+    CS.write(data);
+    memset(data.bytes, 0x22, sizeof(data.bytes));
+    CS.write(data);
+
+    EE.transactions = 0;
+    EE.cutAfter = cut;
+    memset(data.bytes, 0x33, sizeof(data.bytes));
+    CS.write(data);
+    EE.powerOn();
+
+    I2C_eeprom_cyclic_store<LargeTestData, PowerCutEEPROM> CS2;
+    CS2.begin(EE, 32, 32);
+    CS2.read(data);
+    uint8_t first = data.bytes[0];
+    bool mixed = first != 0x22 && first != 0x33;
+    for (uint8_t i = 1; i < sizeof(data.bytes); i++)
+      if (data.bytes[i] != first) mixed = true;
+    if (mixed) torn++;
+  }
+  return torn;
+}
+
+/**
+ * Verify that a power cut during a write leaves either the old
+ * or the new value when the header is written last.
+ */
+unittest(cyclic_store_power_cut_header_last)
+{
+  // the fake does detect torn writes with the default order
+  assertNotEqual(0, countTornWrites(false));
+  assertEqual(0, countTornWrites(true));
+}
+
 unittest_main()
 
 // --------
@@ -0,0 +1,253 @@
+//
+//    FILE: unit_test_ftl.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_ftl class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_ftl.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+// 4 physical pages, 3 logical pages of 25 bytes
+#define FTL_PAGES   4
+#define FTL_SPARES  1
+
+uint8_t crc8(uint8_t crc, const uint8_t *data, uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+void makePage(uint8_t *page, uint32_t seq, uint16_t logical, uint8_t value)
+{
+  memcpy(page, &seq, 4);
+  memcpy(page + 4, &logical, 2);
+  memset(page + 7, value, 25);
+  page[6] = crc8(crc8(0, page, 6), page + 7, 25);
+}
+
+void pushPage(std::deque<uint8_t> *miso, const uint8_t *page)
+{
+  for (int i = 0; i < 32; i++) miso->push_back(page[i]);
+}
+
+void pushBlank(std::deque<uint8_t> *miso, int pages)
+{
+  for (int i = 0; i < pages * 32; i++) miso->push_back(0xFF);
+}
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that a blank region mounts without logical pages.
+ */
+unittest(ftl_blank_mount)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  pushBlank(miso, FTL_PAGES);
+
+  uint16_t map[I2C_EEPROM_FTL_MAPSIZE(FTL_PAGES, FTL_SPARES)];
+  I2C_eeprom_ftl FTL;
+  assertEqual(true, FTL.begin(EE, map, 0, FTL_PAGES, FTL_SPARES));
+  assertEqual(3, FTL.getLogicalPages());
+  assertEqual(25, FTL.getPayloadSize());
+  assertEqual(75, FTL.getLogicalSize());
+  assertEqual(I2C_EEPROM_FTL_NONE, FTL.getPhysicalPage(0));
+
+  // unwritten pages read as 0xFF without bus access
+  mosi->clear();
+  uint8_t buffer[30];
+  assertEqual(30, FTL.read(20, buffer, 30));
+  assertEqual(0xFF, buffer[0]);
+  assertEqual(0xFF, buffer[29]);
+  assertEqual(0, mosi->size());
+
+  assertEqual(-1, FTL.write(70, buffer, 6));
+}
+
+/**
+ * Verify that rewriting a logical page moves it to the next free page.
+ */
+unittest(ftl_write_moves_page)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  pushBlank(miso, FTL_PAGES);
+  uint16_t map[I2C_EEPROM_FTL_MAPSIZE(FTL_PAGES, FTL_SPARES)];
+  I2C_eeprom_ftl FTL;
+  FTL.begin(EE, map, 0, FTL_PAGES, FTL_SPARES);
+
+  // writing 0xFF to an unwritten page is skipped
+  uint8_t value = 0xFF;
+  mosi->clear();
+  assertEqual(0, FTL.write(0, &value, 1));
+  assertEqual(0, mosi->size());
+
+  value = 'a';
+  assertEqual(0, FTL.write(0, &value, 1));
+  assertEqual(0, FTL.getPhysicalPage(0));
+
+  // page 0 as one page split at the TWI buffer { seq 1, logical 0, crc, 'a', 0xFF ... }
+  assertEqual(2 + 30 + 2 + 2, mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual(1, (*mosi)[2]);
+  assertEqual(0, (*mosi)[6]);
+  assertEqual('a', (*mosi)[9]);
+  assertEqual(0xFF, (*mosi)[10]);
+
+  uint8_t page[32];
+  makePage(page, 1, 0, 0xFF);
+  page[7] = 'a';
+  page[6] = crc8(crc8(0, page, 6), page + 7, 25);
+  assertEqual(page[6], (*mosi)[8]);
+
+  // same data again, read in two parts but no write
+  pushPage(miso, page);
+  mosi->clear();
+  assertEqual(0, FTL.write(0, &value, 1));
+  assertEqual(4, mosi->size());
+
+  // new data goes to page 1
+  pushPage(miso, page);
+  value = 'b';
+  mosi->clear();
+  assertEqual(0, FTL.write(0, &value, 1));
+  assertEqual(1, FTL.getPhysicalPage(0));
+  assertEqual(0x00, (*mosi)[4]);
+  assertEqual(0x20, (*mosi)[5]);
+  assertEqual(2, (*mosi)[6]);
+}
+
+/**
+ * Verify that begin() takes the newest valid copy of a
+ * logical page and skips a torn one.
+ */
+unittest(ftl_mount_newest_copy)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t page[32];
+  makePage(page, 1, 0, 0x11);
+  pushPage(miso, page);
+  makePage(page, 2, 0, 0x22);
+  pushPage(miso, page);
+  // seq of page 0 when page 1 replaces it
+  for (int i = 0; i < 4; i++) miso->push_back(i == 0 ? 1 : 0);
+  makePage(page, 3, 0, 0x33);
+  page[20] = 0;                 // torn
+  pushPage(miso, page);
+  makePage(page, 1, 2, 0x44);   // logical 2
+  pushPage(miso, page);
+
+  uint16_t map[I2C_EEPROM_FTL_MAPSIZE(FTL_PAGES, FTL_SPARES)];
+  I2C_eeprom_ftl FTL;
+  assertEqual(true, FTL.begin(EE, map, 0, FTL_PAGES, FTL_SPARES));
+  assertEqual(0, miso->size());
+  assertEqual(1, FTL.getPhysicalPage(0));
+  assertEqual(I2C_EEPROM_FTL_NONE, FTL.getPhysicalPage(1));
+  assertEqual(3, FTL.getPhysicalPage(2));
+
+  // reads from page 1 after the header
+  for (int i = 0; i < 4; i++) miso->push_back(0x22);
+  mosi->clear();
+  uint8_t buffer[4];
+  assertEqual(4, FTL.read(3, buffer, 4));
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x20 + 7 + 3, (*mosi)[1]);
+
+  // next write goes after the newest page, to the torn one
+  uint8_t value = 1;
+  mosi->clear();
+  assertEqual(0, FTL.write(25, &value, 1));
+  assertEqual(2, FTL.getPhysicalPage(1));
+  assertEqual(3, (*mosi)[2]);
+}
+
+/**
+ * Verify that a page that is never written is moved
+ * so that its physical page takes part in the rotation.
+ */
+unittest(ftl_static_relocation)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  pushBlank(miso, FTL_PAGES);
+  uint16_t map[I2C_EEPROM_FTL_MAPSIZE(FTL_PAGES, FTL_SPARES)];
+  I2C_eeprom_ftl FTL;
+  FTL.begin(EE, map, 0, FTL_PAGES, FTL_SPARES);
+  FTL.setStaticInterval(1);
+
+  uint8_t value = 1;
+  FTL.write(0, &value, 1);      // logical 0 -> page 0
+  FTL.write(25, &value, 1);     // logical 1 -> page 1
+  FTL.write(50, &value, 1);     // logical 2 -> page 2
+
+  uint8_t page[32];
+  makePage(page, 1, 0, 0);
+  for (value = 2; value <= 3; value++)
+  {
+    pushPage(miso, page);
+    FTL.write(0, &value, 1);
+  }
+  assertEqual(0, FTL.getRelocations());
+  assertEqual(0, FTL.getPhysicalPage(0));
+
+  // the next write of logical 0 passes logical 1 and 2 to reach page 3,
+  // logical 1 then moves to page 0
+  pushPage(miso, page);
+  makePage(page, 2, 1, 0);
+  pushPage(miso, page);
+  value = 4;
+  assertEqual(0, FTL.write(0, &value, 1));
+  assertEqual(1, FTL.getRelocations());
+  assertEqual(3, FTL.getPhysicalPage(0));
+  assertEqual(0, FTL.getPhysicalPage(1));
+  assertEqual(2, FTL.getPhysicalPage(2));
+  assertEqual(0, miso->size());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,213 @@
+//
+//    FILE: unit_test_hash.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_hash class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_hash.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+// 4 byte values => 4 slots of 8 bytes per bucket
+// home buckets of 4 buckets: key 1 => 3, 4 => 1, 6 => 0, 8, 9, 16, 17 => 3
+// home buckets of 2 buckets: key 2, 3, 6 => 0
+#define E  I2C_EEPROM_HASH_EMPTY
+#define D  I2C_EEPROM_HASH_DELETED
+
+// bucket of 4 records, the value is the key
+void pushBucket(std::deque<uint8_t> *miso, uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3)
+{
+  uint32_t keys[4] = { k0, k1, k2, k3 };
+  for (int s = 0; s < 4; s++)
+  {
+    for (int i = 0; i < 4; i++) miso->push_back((keys[s] >> (8 * i)) & 0xFF);
+    for (int i = 0; i < 4; i++) miso->push_back(keys[s] >= D ? 0xFF : (keys[s] >> (8 * i)) & 0xFF);
+  }
+}
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that put() reads the home bucket
+ * and writes the record in one go.
+ */
+unittest(hash_put)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_hash H;
+  assertEqual(false, H.begin(EE, 0, 0, 4));
+  assertEqual(false, H.begin(EE, 0, 4, 40));
+  assertEqual(true, H.begin(EE, 0, 4, 4));
+  assertEqual(4, H.getSlots());
+  assertEqual(16, H.getCapacity());
+  assertEqual(2, H.getRehashThreshold());
+
+  uint32_t value = 0x11223344;
+  assertEqual(-1, H.put(D, &value));
+
+  pushBucket(miso, E, E, E, E);
+  mosi->clear();
+  assertEqual(0, H.put(4, &value));
+  assertEqual(1, H.getProbes());
+  // read of bucket 1, 30 + 2 bytes
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual(0x3E, (*mosi)[3]);
+  // one write of key and value
+  assertEqual(4 + 2 + 8, mosi->size());
+  assertEqual(0x00, (*mosi)[4]);
+  assertEqual(0x20, (*mosi)[5]);
+  assertEqual(4, (*mosi)[6]);
+  assertEqual(0x44, (*mosi)[10]);
+  assertEqual(0x11, (*mosi)[13]);
+
+  // same value, no write
+  pushBucket(miso, 4, E, E, E);
+  mosi->clear();
+  value = 4;
+  assertEqual(0, H.put(4, &value));
+  assertEqual(4, mosi->size());
+}
+
+/**
+ * Verify that a lookup continues in the next
+ * bucket, wrapping around, if the bucket is full.
+ */
+unittest(hash_get_probe)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_hash H;
+  H.begin(EE, 0, 4, 4);
+
+  pushBucket(miso, 8, 9, 16, 17);
+  pushBucket(miso, 6, 1, E, E);
+  mosi->clear();
+  uint32_t value = 0;
+  assertEqual(true, H.get(1, &value));
+  assertEqual(1, value);
+  assertEqual(2, H.getProbes());
+  assertEqual(0x60, (*mosi)[1]);
+  assertEqual(0x00, (*mosi)[5]);
+
+  // a bucket with an empty slot ends the search
+  pushBucket(miso, 8, E, 16, 17);
+  assertEqual(false, H.contains(1));
+  assertEqual(1, H.getProbes());
+  assertEqual(0, miso->size());
+}
+
+/**
+ * Verify that remove() only leaves a deleted slot
+ * if the bucket has no empty slot.
+ */
+unittest(hash_remove)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_hash H;
+  H.begin(EE, 0, 4, 4);
+  H.setRehashThreshold(0);
+
+  pushBucket(miso, 8, 1, 9, 17);
+  pushBucket(miso, 8, D, 9, 17);
+  pushBucket(miso, E, E, E, E);
+  mosi->clear();
+  assertEqual(true, H.remove(1));
+  assertEqual(1, H.getDeleted());
+  assertEqual(0x68, (*mosi)[5]);
+  assertEqual(0xFE, (*mosi)[6]);
+  assertEqual(0xFF, (*mosi)[9]);
+
+  pushBucket(miso, 6, E, E, E);
+  pushBucket(miso, E, E, E, E);
+  mosi->clear();
+  assertEqual(true, H.remove(6));
+  assertEqual(1, H.getDeleted());
+  assertEqual(0x00, (*mosi)[5]);
+  assertEqual(0xFF, (*mosi)[6]);
+
+  pushBucket(miso, E, E, E, E);
+  assertEqual(false, H.remove(6));
+  assertEqual(0, miso->size());
+}
+
+/**
+ * Verify that rehash() moves a record back to its home bucket
+ * before it frees deleted slots.
+ */
+unittest(hash_rehash)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_hash H;
+  H.begin(EE, 0, 2, 4);
+
+  // key 6 moves to the first deleted slot of bucket 0
+  pushBucket(miso, D, D, 2, 3);
+  pushBucket(miso, 6, E, E, E);
+  pushBucket(miso, D, D, 2, 3);
+  // nothing moves anymore
+  pushBucket(miso, 6, D, 2, 3);
+  pushBucket(miso, D, E, E, E);
+  // deleted slots become empty
+  pushBucket(miso, 6, D, 2, 3);
+  pushBucket(miso, D, E, E, E);
+
+  mosi->clear();
+  assertEqual(0, H.rehash());
+  assertEqual(0, miso->size());
+  assertEqual(0, H.getDeleted());
+  // 7 bucket reads, 6 moved, its old slot deleted, both buckets written
+  assertEqual(7 * 4 + (2 + 8) + (2 + 4) + 2 * (2 + 30 + 2 + 2), mosi->size());
+  assertEqual(0x00, (*mosi)[13]);
+  assertEqual(6, (*mosi)[14]);
+  assertEqual(0x20, (*mosi)[23]);
+  assertEqual(0xFE, (*mosi)[24]);
+  // then the deleted slots of both buckets become empty
+  assertEqual(6, (*mosi)[42]);
+  assertEqual(0xFF, (*mosi)[50]);
+  assertEqual(0x20, (*mosi)[81]);
+  assertEqual(0xFF, (*mosi)[82]);
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,107 @@
+//
+//    FILE: unit_test_layout.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the compile time layout of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_layout.h"
+
+#define I2C_EEPROM_ADDR 0x50
+
+struct Config
+{
+  uint8_t data[20];
+};
+
+struct Sample
+{
+  uint16_t a;
+  uint16_t b;
+};
+
+// 24LC32, 32 byte pages
+typedef I2C_eeprom_layout<I2C_DEVICESIZE_24LC32, 32,
+  I2C_eeprom_var_region<Config>,              // page aligned
+  I2C_eeprom_var_region<uint16_t, 2>,         // directly after it
+  I2C_eeprom_var_region<Config, 1>,           // would straddle a page
+  I2C_eeprom_array_region<Sample, 100>,       // larger than a page
+  I2C_eeprom_store_region<Config, 4>          // 4 slots of 1 page
+> Layout;
+
+enum { CONFIG, BOOTS, BACKUP, SAMPLES, STORE };
+
+// all of it is known by the compiler
+static_assert(Layout::address<BACKUP>() == 32, "straddling region not moved");
+static_assert(Layout::address<STORE>() == 480, "store not page aligned");
+
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify the addresses assigned to the regions.
+ */
+unittest(layout_addresses)
+{
+  assertEqual(5, Layout::count());
+  assertEqual(0, Layout::address<CONFIG>());
+  assertEqual(20, Layout::address<BOOTS>());
+  assertEqual(32, Layout::address<BACKUP>());
+  assertEqual(64, Layout::address<SAMPLES>());
+  assertEqual(400, Layout::size<SAMPLES>());
+  assertEqual(480, Layout::address<STORE>());
+  assertEqual(15, Layout::firstPage<STORE>());
+  assertEqual(4, Layout::pages<STORE>());
+  assertEqual(608, Layout::used());
+  assertEqual(4096 - 608, Layout::available());
+}
+
+/**
+ * Verify that the accessors are bound to the regions.
+ */
+unittest(layout_accessors)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_DEVICESIZE_24LC32);
+  EE.begin();
+  assertEqual(true, Layout::check(EE));
+  I2C_eeprom EE2(I2C_EEPROM_ADDR, I2C_DEVICESIZE_24LC64);
+  assertEqual(false, Layout::check(EE2));
+
+  auto boots = Layout::get<BOOTS>(EE);
+  assertEqual(20, boots.address());
+  assertEqual(true, boots.put(7));
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(20, (*mosi)[1]);
+
+  auto samples = Layout::get<SAMPLES>(EE);
+  assertEqual(100, samples.size());
+  assertEqual(64 + 4 * 99, samples.address(99));
+
+  // empty store, the first slot header is read
+  for (int i = 0; i < 4; i++) miso->push_back(0xFF);
+  mosi->clear();
+  I2C_eeprom_cyclic_store<Config> store;
+  assertEqual(true, Layout::begin<STORE>(store, EE));
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0xE0, (*mosi)[1]);
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,161 @@
+//
+//    FILE: unit_test_partition.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_partition_table class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_partition.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that a blank eeprom has no partition table.
+ */
+unittest(partition_blank_eeprom)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  for (int i = 0; i < 16; i++) miso->push_back(0xFF);
+
+  I2C_eeprom_partition_table PT;
+  assertEqual(false, PT.begin(EE));
+  assertEqual(0, PT.count());
+}
+
+/**
+ * Verify that format() writes an empty table and that
+ * the partitions start after the pages of the table.
+ */
+unittest(partition_format)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_partition_table PT;
+  PT.begin(EE, 2);
+  mosi->clear();
+
+  assertEqual(true, PT.format());
+  assertEqual(0, PT.count());
+
+  // both header copies written at page 2, second copy first
+  assertEqual(2 * (2 + 8), mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x48, (*mosi)[1]);
+  assertEqual('E', (*mosi)[2]);
+  assertEqual('E', (*mosi)[3]);
+  assertEqual('P', (*mosi)[4]);
+  assertEqual('T', (*mosi)[5]);
+  // seq 1, count 0
+  assertEqual(1, (*mosi)[6]);
+  assertEqual(0, (*mosi)[7]);
+  assertEqual(0, (*mosi)[8]);
+  // first copy seq 2
+  assertEqual(0x40, (*mosi)[11]);
+  assertEqual(2, (*mosi)[16]);
+
+  // entry 0 after both copies, read back for the crc,
+  // then the older copy with seq 3
+  mosi->clear();
+  assertEqual(true, PT.add("settings", 4));
+  assertEqual((2 + 12) + 2 + (2 + 8), mosi->size());
+  assertEqual(0x50, (*mosi)[1]);
+  assertEqual('s', (*mosi)[2]);
+  assertEqual(0x48, (*mosi)[17]);
+  assertEqual(3, (*mosi)[22]);
+  assertEqual(1, (*mosi)[24]);
+
+  uint16_t tableBytes = 2 * 8 + I2C_EEPROM_PARTITIONS * 12;
+  assertMoreOrEqual(PT.getFreePage(), 2 + tableBytes / 32);
+  assertEqual(128 - PT.getFreePage(), PT.getFreePages());
+
+  uint16_t firstPage, pages;
+  assertEqual(false, PT.find("none", firstPage, pages));
+  assertEqual(false, PT.add("big", 128));
+}
+
+// header copy { "EEPT", seq, count, crc } over seq, count and the entries
+void pushHeader(std::deque<uint8_t> *miso, uint16_t seq, uint8_t count, const uint8_t *entries, bool torn)
+{
+  uint8_t crc = 0;
+  uint8_t data[3] = { (uint8_t)(seq & 0xFF), (uint8_t)(seq >> 8), count };
+  for (int i = 0; i < 3 + count * 12; i++)
+  {
+    crc ^= (i < 3) ? data[i] : entries[i - 3];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  if (torn) crc ^= 0x55;
+  uint8_t header[8] = { 'E', 'E', 'P', 'T', data[0], data[1], count, crc };
+  for (int i = 0; i < 8; i++) miso->push_back(header[i]);
+}
+
+/**
+ * Verify that a reset during add(), after the entry or during the
+ * write of the header, leaves the previous table.
+ */
+unittest(partition_add_reset)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // entries { "settings", 4, 64 } and { "counters", 68, 8 }
+  uint8_t entries[24] = { 's', 'e', 't', 't', 'i', 'n', 'g', 's', 4, 0, 64, 0,
+                          'c', 'o', 'u', 'n', 't', 'e', 'r', 's', 68, 0, 8, 0 };
+
+  // copy 0 seq 1 with one entry, copy 1 seq 2 with two torn
+  pushHeader(miso, 1, 1, entries, false);
+  pushHeader(miso, 2, 2, entries, true);
+  // entry 0 for the crc of copy 0, both for copy 1, entry 0 for the free page
+  for (int i = 0; i < 12; i++) miso->push_back(entries[i]);
+  for (int i = 0; i < 24; i++) miso->push_back(entries[i]);
+  for (int i = 0; i < 12; i++) miso->push_back(entries[i]);
+
+  I2C_eeprom_partition_table PT;
+  assertEqual(true, PT.begin(EE));
+  assertEqual(0, miso->size());
+  assertEqual(1, PT.count());
+  assertEqual(68, PT.getFreePage());
+
+  // same, copy 1 written, the newest is used
+  pushHeader(miso, 1, 1, entries, false);
+  pushHeader(miso, 2, 2, entries, false);
+  for (int i = 0; i < 12; i++) miso->push_back(entries[i]);
+  for (int i = 0; i < 24; i++) miso->push_back(entries[i]);
+  for (int i = 12; i < 24; i++) miso->push_back(entries[i]);
+  assertEqual(true, PT.begin(EE));
+  assertEqual(0, miso->size());
+  assertEqual(2, PT.count());
+  assertEqual(76, PT.getFreePage());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,119 @@
+//
+//    FILE: unit_test_reader.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_reader class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_reader.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that byte wise reading refills the window
+ * with bulk reads instead of one read per byte.
+ */
+unittest(reader_sequential_read)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  for (int i = 0; i < 40; i++) miso->push_back(i);
+
+  I2C_eeprom_reader reader(EE, 0x0200, 40);
+  assertEqual(40, reader.available());
+  for (int i = 0; i < 40; i++)
+  {
+    assertEqual(i, reader.peek());
+    assertEqual(i, reader.read());
+  }
+  assertEqual(0, reader.available());
+  assertEqual(-1, reader.read());
+
+  // two refills of 30 and 10 bytes
+  assertEqual(4, mosi->size());
+  assertEqual(0x02, (*mosi)[0]);
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual(0x02, (*mosi)[2]);
+  assertEqual(30, (*mosi)[3]);
+}
+
+/**
+ * Verify that seek() stays within the region and
+ * that a seek outside the window causes a refill.
+ */
+unittest(reader_seek)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_reader reader(EE, 0x0100, 100);
+  reader.setWindow(8);
+  assertEqual(8, reader.getWindow());
+
+  assertEqual(false, reader.seek(0x00FF));
+  assertEqual(false, reader.seek(0x0165));
+  assertEqual(true, reader.seek(0x0150));
+  assertEqual(0x0150, reader.position());
+
+  for (int i = 0; i < 8; i++) miso->push_back(0xA0 + i);
+  assertEqual(0xA0, reader.read());
+  assertEqual(0xA1, reader.read());
+  assertEqual(2, mosi->size());
+  assertEqual(0x50, (*mosi)[1]);
+}
+
+/**
+ * Verify that a region at the top of a 64 KB device
+ * ends at 0x10000 instead of wrapping to 0.
+ */
+unittest(reader_device_end)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_DEVICESIZE_24LC512);
+  EE.begin();
+
+  for (int i = 0; i < 16; i++) miso->push_back(i);
+
+  I2C_eeprom_reader reader(EE, 0xFFF0, 16);
+  assertEqual(16, reader.available());
+  uint8_t buffer[20];
+  assertEqual(16, reader.read(buffer, 20));
+  assertEqual(15, buffer[15]);
+  assertEqual(0, reader.available());
+  assertEqual(-1, reader.read());
+  assertEqual(0x10000, reader.position());
+  assertEqual(true, reader.seek(0xFFFF));
+  assertEqual(1, reader.available());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,214 @@
+//
+//    FILE: unit_test_remap.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_remap class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_remap.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 128 pages of 32 bytes
+
+// table at page 120, spares from page 121
+#define TABLE_PAGE  120
+
+uint8_t bad[128 / 8];
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+void pushBytes(std::deque<uint8_t> *miso, uint8_t value, int count)
+{
+  for (int i = 0; i < count; i++) miso->push_back(value);
+}
+
+/**
+ * Verify that a blank eeprom has no table and format() writes one.
+ */
+unittest(remap_blank_format)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_remap RM;
+  // not initialized
+  assertEqual(-1, RM.erase(0, 32));
+  assertEqual(0, mosi->size());
+
+  pushBytes(miso, 0xFF, 8);
+  assertEqual(false, RM.begin(EE, bad, TABLE_PAGE, 4));
+  assertEqual(0, RM.count());
+  assertEqual(4, RM.getFreeSpares());
+  assertEqual(TABLE_PAGE + 1 + 4, RM.getFreePage());
+
+  mosi->clear();
+  assertEqual(true, RM.format());
+  assertEqual(0x0F, (*mosi)[0]);
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual('E', (*mosi)[2]);
+  assertEqual('E', (*mosi)[3]);
+  assertEqual('B', (*mosi)[4]);
+  assertEqual('P', (*mosi)[5]);
+  assertEqual(0, (*mosi)[6]);
+}
+
+/**
+ * Verify that a write that reads back correctly stays in place.
+ */
+unittest(remap_verify_ok)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_remap RM;
+  RM.begin(EE, bad, TABLE_PAGE, 4);
+  RM.format();
+
+  uint8_t data[4] = { 1, 2, 3, 4 };
+  for (int i = 0; i < 4; i++) miso->push_back(data[i]);
+  mosi->clear();
+  assertEqual(0, RM.writeBlock(0x100, data, 4));
+  assertEqual(0, RM.count());
+  assertEqual(false, RM.isBad(8));
+  assertEqual(0, miso->size());
+  // write + address of the read back
+  assertEqual(2 + 4 + 2, mosi->size());
+
+  RM.setVerify(false);
+  mosi->clear();
+  assertEqual(0, RM.writeBlock(0x100, data, 4));
+  assertEqual(2 + 4, mosi->size());
+}
+
+/**
+ * Verify that a page failing verification is moved to a spare.
+ */
+unittest(remap_write_failure)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_remap RM;
+  RM.begin(EE, bad, TABLE_PAGE, 4);
+  RM.format();
+
+  uint8_t data[4] = { 1, 2, 3, 4 };
+  pushBytes(miso, 0, 4);        // read back fails
+  pushBytes(miso, 0x55, 32);    // content of page 8
+  pushBytes(miso, 0x55, 2);     // read back of the spare
+  for (int i = 0; i < 4; i++) miso->push_back(data[i]);
+  pushBytes(miso, 0x55, 26);
+  mosi->clear();
+  assertEqual(0, RM.writeBlock(0x102, data, 4));
+  assertEqual(0, miso->size());
+  assertEqual(1, RM.count());
+  assertEqual(3, RM.getFreeSpares());
+  assertEqual(true, RM.isBad(8));
+  assertEqual(121, RM.getPhysicalPage(8));
+  assertEqual(9, RM.getPhysicalPage(9));
+
+  // spare written with the old content and the new data
+  // write 2+4, read back 2, read page 2+2, spare 2+30 and 2+2
+  assertEqual(0x0F, (*mosi)[12]);
+  assertEqual(0x20, (*mosi)[13]);
+  assertEqual(0x55, (*mosi)[14]);
+  assertEqual(1, (*mosi)[16]);
+  assertEqual(4, (*mosi)[19]);
+
+  // reads go to the spare
+  pushBytes(miso, 0, 2);
+  mosi->clear();
+  uint8_t buffer[2];
+  assertEqual(2, RM.readBlock(0x104, buffer, 2));
+  assertEqual(0x0F, (*mosi)[0]);
+  assertEqual(0x24, (*mosi)[1]);
+}
+
+/**
+ * Verify that a failing spare is skipped and that
+ * writes fail when no spare is left.
+ */
+unittest(remap_no_spare_left)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_remap RM;
+  RM.begin(EE, bad, TABLE_PAGE, 1);
+  RM.format();
+
+  uint8_t data[4] = { 1, 2, 3, 4 };
+  pushBytes(miso, 0, 4);
+  pushBytes(miso, 0, 32);
+  pushBytes(miso, 0, 32);       // spare fails as well
+  assertEqual(-1, RM.writeBlock(0, data, 4));
+  assertEqual(1, RM.count());
+  assertEqual(0, RM.getFreeSpares());
+}
+
+/**
+ * Verify that begin() loads the table and marks the bad pages.
+ */
+unittest(remap_load)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // header { "EEBP", count 2, crc, padding }, entries { 8, 8 }
+  uint8_t table[12] = { 'E', 'E', 'B', 'P', 2, 0, 0, 0, 8, 0, 8, 0 };
+  uint8_t crc = 0;
+  uint8_t crcData[5] = { 2, 8, 0, 8, 0 };
+  for (int i = 0; i < 5; i++)
+  {
+    crc ^= crcData[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  table[5] = crc;
+  for (int i = 0; i < 12; i++) miso->push_back(table[i]);
+
+  I2C_eeprom_remap RM;
+  assertEqual(true, RM.begin(EE, bad, TABLE_PAGE, 4));
+  assertEqual(2, RM.count());
+  assertEqual(true, RM.isBad(8));
+  assertEqual(false, RM.isBad(7));
+  // the second spare replaced the first one
+  assertEqual(122, RM.getPhysicalPage(8));
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,206 @@
+//
+//    FILE: unit_test_scheduler.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_scheduler class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_scheduler.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that overlapping and adjacent writes
+ * to one page cost one page program.
+ */
+unittest(scheduler_merge)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t cache[4 * 32];
+  I2C_eeprom_scheduler scheduler;
+  assertEqual(false, scheduler.begin(EE, cache, 0));
+  assertEqual(true, scheduler.begin(EE, cache, 4));
+
+  mosi->clear();
+  assertEqual(0, scheduler.writeBlock(0x40, (uint8_t *)"abcd", 4));
+  assertEqual(0, scheduler.writeBlock(0x44, (uint8_t *)"ef", 2));
+  assertEqual(0, scheduler.writeBlock(0x42, (uint8_t *)"XY", 2));
+  assertEqual(0, mosi->size());
+  assertEqual(1, scheduler.pending());
+
+  assertEqual(0, scheduler.flush());
+  assertEqual(0, scheduler.pending());
+  assertEqual(1, scheduler.getPrograms());
+  assertEqual(2 + 6, mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x40, (*mosi)[1]);
+  assertEqual('a', (*mosi)[2]);
+  assertEqual('b', (*mosi)[3]);
+  assertEqual('X', (*mosi)[4]);
+  assertEqual('Y', (*mosi)[5]);
+  assertEqual('e', (*mosi)[6]);
+  assertEqual('f', (*mosi)[7]);
+
+  // nothing queued, nothing written
+  mosi->clear();
+  assertEqual(0, scheduler.flush());
+  assertEqual(0, mosi->size());
+}
+
+/**
+ * Verify that the bytes between two writes
+ * are read so the page is programmed once.
+ */
+unittest(scheduler_gap)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t cache[2 * 32];
+  I2C_eeprom_scheduler scheduler;
+  scheduler.begin(EE, cache, 2);
+
+  scheduler.writeBlock(0x64, (uint8_t *)"cd", 2);
+  miso->push_back(0x11);
+  miso->push_back(0x22);
+  mosi->clear();
+  scheduler.writeBlock(0x60, (uint8_t *)"ab", 2);
+  assertEqual(2, mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x62, (*mosi)[1]);
+
+  mosi->clear();
+  scheduler.flush();
+  assertEqual(2 + 6, mosi->size());
+  assertEqual(0x60, (*mosi)[1]);
+  assertEqual('a', (*mosi)[2]);
+  assertEqual(0x11, (*mosi)[4]);
+  assertEqual(0x22, (*mosi)[5]);
+  assertEqual('d', (*mosi)[7]);
+}
+
+/**
+ * Verify that reads see queued writes and
+ * that pages are programmed in ascending order.
+ */
+unittest(scheduler_read_order)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t cache[4 * 32];
+  I2C_eeprom_scheduler scheduler;
+  scheduler.begin(EE, cache, 4);
+
+  // crosses from page 3 to page 4
+  scheduler.writeBlock(0x7E, (uint8_t *)"xyz", 3);
+  scheduler.writeBlock(0x20, (uint8_t *)"p", 1);
+  assertEqual(3, scheduler.pending());
+
+  for (int i = 0; i < 5; i++) miso->push_back(0xFF);
+  uint8_t buffer[5];
+  assertEqual(5, scheduler.readBlock(0x7D, buffer, 5));
+  assertEqual(0xFF, buffer[0]);
+  assertEqual('x', buffer[1]);
+  assertEqual('y', buffer[2]);
+  assertEqual('z', buffer[3]);
+  assertEqual(0xFF, buffer[4]);
+
+  mosi->clear();
+  assertEqual(0, scheduler.flush());
+  assertEqual(3, scheduler.getPrograms());
+  assertEqual((2 + 1) + (2 + 2) + (2 + 1), mosi->size());
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual(0x7E, (*mosi)[4]);
+  assertEqual(0x80, (*mosi)[8]);
+}
+
+/**
+ * Verify the hold window of poll().
+ */
+unittest(scheduler_window)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t cache[2 * 32];
+  I2C_eeprom_scheduler scheduler;
+  scheduler.begin(EE, cache, 2);
+  assertEqual(10, scheduler.getWindow());
+  scheduler.setWindow(5);
+
+  mosi->clear();
+  scheduler.writeBlock(0x10, (uint8_t *)"a", 1);
+  assertEqual(0, scheduler.poll());
+  assertEqual(0, mosi->size());
+
+  delay(10);
+  assertEqual(0, scheduler.poll());
+  assertEqual(3, mosi->size());
+  assertEqual(0, scheduler.pending());
+}
+
+/**
+ * Verify that a full cache is programmed
+ * when another page is written.
+ */
+unittest(scheduler_full)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint8_t cache[2 * 32];
+  I2C_eeprom_scheduler scheduler;
+  scheduler.begin(EE, cache, 2);
+
+  scheduler.writeBlock(0xA0, (uint8_t *)"a", 1);
+  scheduler.writeBlock(0x40, (uint8_t *)"b", 1);
+  mosi->clear();
+  scheduler.writeBlock(0x120, (uint8_t *)"c", 1);
+  assertEqual(6, mosi->size());
+  assertEqual(0x40, (*mosi)[1]);
+  assertEqual(0xA0, (*mosi)[4]);
+  assertEqual(1, scheduler.pending());
+}
+
+unittest_main()
+
+// --------
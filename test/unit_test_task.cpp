@@ -0,0 +1,168 @@
+//
+//    FILE: unit_test_task.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_task class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+// the tests run with the std::thread port of the host.
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_task.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that a short read is handled between
+ * the page chunks of a long write.
+ */
+unittest(task_page_interleave)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_task task;
+  assertEqual(true, task.begin(EE));
+  assertEqual(false, task.step());
+
+  uint8_t data[96];
+  for (int i = 0; i < 96; i++) data[i] = i;
+  uint8_t buffer[4];
+  for (int i = 0; i < 4; i++) miso->push_back('a' + i);
+
+  I2C_eeprom_request write, read;
+  assertEqual(true, task.submit(write, I2C_eeprom_request::WRITE, 0, data, 96));
+  assertEqual(true, task.submit(read, I2C_eeprom_request::READ, 0x100, buffer, 4));
+  assertEqual(2, task.pending());
+
+  // first page of the write, split at the TWI buffer
+  mosi->clear();
+  assertEqual(true, task.step());
+  assertEqual(2 + 30 + 2 + 2, mosi->size());
+  assertEqual(false, task.isDone(write));
+
+  // then the read
+  mosi->clear();
+  assertEqual(true, task.step());
+  assertEqual(2, mosi->size());
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual(true, task.isDone(read));
+  assertEqual(4, task.wait(read));
+  assertEqual('d', buffer[3]);
+  assertEqual(1, task.pending());
+
+  // the rest of the write
+  mosi->clear();
+  assertEqual(true, task.step());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual(32, (*mosi)[2]);
+  assertEqual(true, task.step());
+  assertEqual(true, task.isDone(write));
+  assertEqual(0, task.wait(write));
+  assertEqual(false, task.step());
+  assertEqual(0, task.pending());
+}
+
+/**
+ * Verify that without an I/O task wait() handles
+ * only its own request, not the first one queued.
+ */
+unittest(task_wait_own_request)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_task task;
+  task.begin(EE);
+
+  uint8_t data[96];
+  memset(data, 0x55, sizeof(data));
+  uint8_t buffer[4];
+  for (int i = 0; i < 4; i++) miso->push_back('a' + i);
+
+  I2C_eeprom_request write, read;
+  task.submit(write, I2C_eeprom_request::WRITE, 0, data, 96);
+  task.submit(read, I2C_eeprom_request::READ, 0x100, buffer, 4);
+
+  mosi->clear();
+  assertEqual(4, task.wait(read));
+  assertEqual(2, mosi->size());
+  assertEqual('a', buffer[0]);
+  assertEqual(false, task.isDone(write));
+  assertEqual(1, task.pending());
+
+  // the whole write, three pages
+  mosi->clear();
+  assertEqual(0, task.wait(write));
+  assertEqual(3 * (2 + 30 + 2 + 2), mosi->size());
+  assertEqual(true, task.isDone(write));
+  assertEqual(0, task.pending());
+  assertEqual(false, task.step());
+}
+
+/**
+ * Verify the blocking calls with the I/O task
+ * running and requests from another thread.
+ */
+unittest(task_thread)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_task task;
+  task.begin(EE);
+  assertEqual(true, task.start());
+  assertEqual(true, task.isRunning());
+  assertEqual(false, task.start());
+
+  uint8_t data[40];
+  memset(data, 0x55, sizeof(data));
+  for (int i = 0; i < 4; i++) miso->push_back('a' + i);
+  int rv = -1;
+  std::thread writer([&] { rv = task.writeBlock(0, data, 40); });
+
+  uint8_t buffer[4];
+  assertEqual(4, task.readBlock(0x100, buffer, 4));
+  assertEqual('a', buffer[0]);
+  writer.join();
+  assertEqual(0, rv);
+
+  task.stop();
+  assertEqual(false, task.isRunning());
+  assertEqual(0, task.pending());
+  // write of 32 + 8 bytes, read of 4 bytes
+  assertEqual((2 + 30 + 2 + 2) + (2 + 8) + 2, mosi->size());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,222 @@
+//
+//    FILE: unit_test_timeseries.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_timeseries class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_timeseries.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+// 4 byte samples => 3 samples per page, series of 8 pages at page 0
+uint8_t buffer[32];
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+// bytes of page { seq, time, 3, crc } with samples at time, + 10, + 20, the sample is its time
+void pushPage(std::deque<uint8_t> *miso, uint32_t seq, uint32_t time, int first, int length)
+{
+  uint8_t page[32];
+  memset(page, 0xFF, 32);
+  memcpy(page, &seq, 4);
+  memcpy(page + 4, &time, 4);
+  page[8] = 3;
+  for (int i = 0; i < 3; i++)
+  {
+    uint16_t delta  = i * 10;
+    uint32_t sample = time + delta;
+    memcpy(page + 10 + i * 6, &delta, 2);
+    memcpy(page + 12 + i * 6, &sample, 4);
+  }
+  uint8_t crc = 0;
+  for (int i = 0; i < 28; i++)
+  {
+    if (i == 9) continue;
+    crc ^= page[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  page[9] = crc;
+  for (int i = first; i < first + length; i++) miso->push_back(page[i]);
+}
+
+/**
+ * Verify that a blank region is an empty series.
+ */
+unittest(timeseries_begin_blank)
+{
+  Wire.resetMocks();
+
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_timeseries TS;
+  assertEqual(false, TS.begin(EE, buffer, 0, 8, 30));
+  assertEqual(false, TS.begin(EE, buffer, 0, 1, 4));
+  assertEqual(false, TS.begin(EE, NULL, 0, 8, 4));
+
+  for (int i = 0; i < 10; i++) miso->push_back(0xFF);
+  assertEqual(true, TS.begin(EE, buffer, 0, 8, 4));
+  assertEqual(3, TS.getSlots());
+  assertEqual(0, TS.getPages());
+  assertEqual(1, TS.getReads());
+
+  uint32_t time;
+  uint32_t sample;
+  assertEqual(true, TS.seekLatest(5));
+  assertEqual(false, TS.next(time, &sample));
+}
+
+/**
+ * Verify that a page is written when full or when the time
+ * does not fit in the 16 bit delta, and the latest samples.
+ */
+unittest(timeseries_append)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  for (int i = 0; i < 10; i++) miso->push_back(0xFF);
+  I2C_eeprom_timeseries TS;
+  TS.begin(EE, buffer, 0, 8, 4);
+
+  mosi->clear();
+  uint32_t sample = 0x11223344;
+  assertEqual(0, TS.append(1000, &sample));
+  assertEqual(0, TS.append(1005, &sample));
+  assertEqual(0, mosi->size());
+  assertEqual(0, TS.append(1010, &sample));
+  // page 0 { seq 0, 1000, 3 } { 0, sample } { 5, sample } { 10, sample }
+  assertEqual(2 + 10 + 3 * 6, mosi->size());
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual(0, (*mosi)[2]);
+  assertEqual(0xE8, (*mosi)[6]);
+  assertEqual(0x03, (*mosi)[7]);
+  assertEqual(3, (*mosi)[10]);
+  assertEqual(0, (*mosi)[12]);
+  assertEqual(0x44, (*mosi)[14]);
+  assertEqual(5, (*mosi)[18]);
+  assertEqual(10, (*mosi)[24]);
+
+  assertEqual(-1, TS.append(999, &sample));
+
+  mosi->clear();
+  sample = 1012;
+  assertEqual(0, TS.append(1012, &sample));
+  sample = 71012;
+  assertEqual(0, TS.append(71012, &sample));
+  // page 1 { seq 1, 1012, 1 } { 0, 1012 }
+  assertEqual(2 + 10 + 6, mosi->size());
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual(1, (*mosi)[2]);
+  assertEqual(1, (*mosi)[10]);
+  assertEqual(3, TS.getPages());
+  assertEqual(71012, TS.getLastTime());
+
+  // the header and the sample of page 1, then the page buffer
+  for (int i = 2; i < 18; i++) miso->push_back((*mosi)[i]);
+  uint32_t time;
+  assertEqual(true, TS.seekLatest(2));
+  assertEqual(1, TS.getReads());
+  assertEqual(true, TS.next(time, &sample));
+  assertEqual(1012, time);
+  assertEqual(1012, sample);
+  assertEqual(true, TS.next(time, &sample));
+  assertEqual(71012, time);
+  assertEqual(false, TS.next(time, &sample));
+  assertEqual(0, miso->size());
+
+  mosi->clear();
+  assertEqual(0, TS.flush());
+  assertEqual(2 + 10 + 6, mosi->size());
+  assertEqual(0x40, (*mosi)[1]);
+  assertEqual(0, TS.flush());
+  assertEqual(2 + 10 + 6, mosi->size());
+
+  // flushed, a time too far for the delta only starts page 3
+  mosi->clear();
+  sample = 141012;
+  assertEqual(0, TS.append(141012, &sample));
+  assertEqual(0, mosi->size());
+  assertEqual(4, TS.getPages());
+  assertEqual(0, TS.flush());
+  assertEqual(2 + 10 + 6, mosi->size());
+  assertEqual(0x60, (*mosi)[1]);
+}
+
+/**
+ * Verify that begin() and seekTime() find the pages
+ * with a binary search over the headers.
+ */
+unittest(timeseries_seek)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // wrapped, pages 0..7 hold seq 8, 9, 10, 3, 4, 5, 6, 7 at time seq * 100
+  pushPage(miso, 8, 800, 0, 10);
+  pushPage(miso, 4, 400, 0, 10);
+  pushPage(miso, 10, 1000, 0, 10);
+  pushPage(miso, 3, 300, 0, 10);
+  pushPage(miso, 10, 1000, 0, 32);
+  pushPage(miso, 3, 300, 0, 10);
+
+  mosi->clear();
+  I2C_eeprom_timeseries TS;
+  assertEqual(true, TS.begin(EE, buffer, 0, 8, 4));
+  assertEqual(0, miso->size());
+  assertEqual(5, TS.getReads());
+  assertEqual(0x00, (*mosi)[1]);
+  assertEqual(0x80, (*mosi)[3]);
+  assertEqual(0x40, (*mosi)[5]);
+  assertEqual(0x60, (*mosi)[7]);
+  assertEqual(7, TS.getPages());
+  assertEqual(1020, TS.getLastTime());
+
+  // pages 7, 5 and 6, then page 6 is read to skip 600 .. 620
+  pushPage(miso, 7, 700, 0, 10);
+  pushPage(miso, 5, 500, 0, 10);
+  pushPage(miso, 6, 600, 0, 10);
+  pushPage(miso, 6, 600, 0, 32);
+  assertEqual(true, TS.seekTime(650));
+  assertEqual(3, TS.getReads());
+  assertEqual(0, miso->size());
+
+  // header and first sample of page 7
+  pushPage(miso, 7, 700, 0, 10);
+  pushPage(miso, 7, 700, 10, 6);
+  uint32_t time;
+  uint32_t sample;
+  assertEqual(true, TS.next(time, &sample));
+  assertEqual(700, time);
+  assertEqual(700, sample);
+  assertEqual(0, miso->size());
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,100 @@
+//
+//    FILE: unit_test_transaction.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_transaction class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_transaction.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096
+
+struct DummyTestData {
+  uint8_t padding;
+};
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that no more than I2C_EEPROM_TRANSACTION_STORES
+ * stores can take part in a transaction.
+ */
+unittest(transaction_add_limit)
+{
+  I2C_eeprom_cyclic_store<DummyTestData> CS[I2C_EEPROM_TRANSACTION_STORES + 1];
+  I2C_eeprom_transaction TX;
+
+  for (int i = 0; i < I2C_EEPROM_TRANSACTION_STORES; i++)
+  {
+    assertEqual(true, TX.add(CS[i]));
+  }
+  assertEqual(false, TX.add(CS[I2C_EEPROM_TRANSACTION_STORES]));
+  assertEqual(I2C_EEPROM_TRANSACTION_STORES, TX.count());
+}
+
+/**
+ * Verify that a commit costs a single write of the
+ * commit record and that a store can be reverted.
+ */
+unittest(transaction_commit_single_write)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // blank store and blank commit log
+  for (int i = 0; i < 8; i++) miso->push_back(0xff);
+
+  I2C_eeprom_cyclic_store<DummyTestData> CS;
+  I2C_eeprom_transaction TX;
+  assertEqual(true, CS.begin(EE, 32, 4, 0));
+  assertEqual(true, TX.begin(EE, 32, 4, 4));
+  assertEqual(true, TX.add(CS));
+
+  // no commit record yet => current state is committed
+  mosi->clear();
+  assertEqual(true, TX.recover());
+  assertEqual(2 + 4 + sizeof(I2C_eeprom_commit_record), mosi->size());
+  // commit log starts at page 4
+  assertEqual(0, (*mosi)[0]);
+  assertEqual(128, (*mosi)[1]);
+
+  DummyTestData data;
+  CS.write(data);
+  assertEqual(0, CS.getVersion());
+
+  mosi->clear();
+  assertEqual(true, TX.commit());
+  assertEqual(2 + 4 + sizeof(I2C_eeprom_commit_record), mosi->size());
+
+  // write without commit, revert reads the header of the older slot
+  CS.write(data);
+  assertEqual(1, CS.getVersion());
+  uint32_t tmp = 0;
+  miso->push_back(((uint8_t*)&tmp)[0]);
+  miso->push_back(((uint8_t*)&tmp)[1]);
+  miso->push_back(((uint8_t*)&tmp)[2]);
+  miso->push_back(((uint8_t*)&tmp)[3]);
+  assertEqual(true, TX.rollback());
+  assertEqual(0, CS.getVersion());
+}
+
+unittest_main()
+
+// --------
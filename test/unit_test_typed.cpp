@@ -0,0 +1,133 @@
+//
+//    FILE: unit_test_typed.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the typed accessors of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_typed.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that put() writes the value at its bound address.
+ */
+unittest(typed_var_put)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_var<uint16_t> var(EE, 0x0102);
+  assertEqual(true, var.put(0x0304));
+
+  // address high, address low, value (little endian host)
+  assertEqual(4, mosi->size());
+  assertEqual(0x01, (*mosi)[0]);
+  assertEqual(0x02, (*mosi)[1]);
+  assertEqual(0x04, (*mosi)[2]);
+  assertEqual(0x03, (*mosi)[3]);
+}
+
+/**
+ * Verify that update() does not write when the value is unchanged.
+ */
+unittest(typed_var_update_unchanged)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  miso->push_back(0x04);
+  miso->push_back(0x03);
+
+  I2C_eeprom_var<uint16_t> var(EE, 0x0010);
+  assertEqual(true, var.update(0x0304));
+
+  // only the address phase of the compare read
+  assertEqual(2, mosi->size());
+}
+
+/**
+ * Verify that forEach() fetches contiguous elements in batches.
+ */
+unittest(typed_array_for_each_batches)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  for (uint16_t i = 0; i < 20; i++)
+  {
+    miso->push_back(i & 0xFF);
+    miso->push_back(i >> 8);
+  }
+
+  I2C_eeprom_array<uint16_t> table(EE, 0x0100, 20);
+  uint16_t sum = 0;
+  uint16_t visited = table.forEach(0, 20, [&](uint16_t index, const uint16_t &value) {
+    sum += value;
+    return index == value;
+  });
+
+  assertEqual(20, visited);
+  assertEqual(190, sum);
+  // 40 bytes in two reads of 30 and 10 bytes -> two address phases
+  assertEqual(4, mosi->size());
+}
+
+/**
+ * Verify that a range longer than the 16 bit length
+ * of a transfer is rejected, not truncated.
+ */
+unittest(typed_array_range_too_long)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // 0x4000 * 4 = 0x10000 bytes, truncated this would be 0
+  static uint32_t values[0x4000];
+  I2C_eeprom_array<uint32_t> table(EE, 0x0000, 0x4000);
+  mosi->clear();
+  assertEqual(0, table.get(0, values, 0x4000));
+  assertEqual(false, table.put(0, values, 0x4000));
+  assertEqual(false, table.update(0, values, 0x4000));
+  assertEqual(0, mosi->size());
+
+  // 0x3FFF * 4 bytes fits
+  assertEqual(true, table.put(1, values, 0x3FFF));
+  assertMoreOrEqual(mosi->size(), 4 * 0x3FFF);
+}
+
+unittest_main()
+
+// --------
@@ -0,0 +1,199 @@
+//
+//    FILE: unit_test_wear.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_wear class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_wear.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 128 pages of 32 bytes
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that every write transaction is counted
+ * in the group of the page it writes to.
+ */
+unittest(wear_counts_writes)
+{
+  Wire.resetMocks();
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint32_t counters[16];
+  I2C_eeprom_wear wear;
+  assertEqual(true, wear.begin(EE, counters, 16));
+  assertEqual(8, wear.getPagesPerGroup());
+  assertEqual(0, wear.getTotal());
+
+  uint8_t buffer[20];
+  memset(buffer, 0, sizeof(buffer));
+  EE.writeByte(0, 1);
+  // crosses from page 7 (group 0) into page 8 (group 1)
+  EE.writeBlock(250, buffer, 20);
+
+  assertEqual(2, wear.getCount(0));
+  assertEqual(1, wear.getCount(1));
+  assertEqual(3, wear.getTotal());
+  assertEqual(2, wear.getMax());
+  assertEqual(I2C_EEPROM_ENDURANCE - 2, wear.getRemaining());
+  assertEqual(3, wear.getUnsaved());
+
+  wear.end();
+  EE.writeByte(0, 1);
+  assertEqual(3, wear.getTotal());
+}
+
+/**
+ * Verify the histogram and the hotspot report.
+ */
+unittest(wear_histogram_hotspots)
+{
+  Wire.resetMocks();
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  uint32_t counters[8];
+  I2C_eeprom_wear wear;
+  wear.begin(EE, counters, 8);
+  uint32_t values[8] = { 5, 0, 120, 3, 45, 0, 120, 9 };
+  memcpy(counters, values, sizeof(values));
+
+  uint16_t bins[4];
+  wear.histogram(bins, 4, 10);
+  assertEqual(5, bins[0]);    // 5, 0, 3, 0, 9
+  assertEqual(0, bins[1]);
+  assertEqual(0, bins[2]);
+  assertEqual(3, bins[3]);    // 120, 45, 120
+
+  uint16_t hot[3];
+  assertEqual(3, wear.hotspots(hot, 3));
+  assertEqual(2, hot[0]);
+  assertEqual(6, hot[1]);
+  assertEqual(4, hot[2]);
+
+  uint16_t all[10];
+  assertEqual(8, wear.hotspots(all, 10));
+  assertEqual(7, all[3]);
+}
+
+/**
+ * Verify that save() writes the counters before the header,
+ * including its own write cycles.
+ */
+unittest(wear_save)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // 8 slots of one page at page 120, all blank
+  for (int i = 0; i < 8 * 4; i++) miso->push_back(0xFF);
+
+  uint32_t counters[4];
+  I2C_eeprom_wear wear;
+  assertEqual(false, wear.begin(EE, counters, 4, 120, 8));
+  assertEqual(0, wear.getTotal());
+
+  EE.writeByte(0, 1);
+  mosi->clear();
+  assertEqual(true, wear.save());
+  assertEqual(0, wear.getUnsaved());
+  assertEqual(1, wear.getCount(0));
+  assertEqual(2, wear.getCount(3));
+
+  // counters at page 120 + 5, then header { seq 0, crc }
+  assertEqual(2 + 16 + 2 + 5, mosi->size());
+  assertEqual(0x0F, (*mosi)[0]);
+  assertEqual(0x05, (*mosi)[1]);
+  assertEqual(1, (*mosi)[2]);
+  assertEqual(2, (*mosi)[14]);
+  assertEqual(0x0F, (*mosi)[18]);
+  assertEqual(0x00, (*mosi)[19]);
+  assertEqual(0, (*mosi)[20]);
+  assertEqual(0, (*mosi)[23]);
+}
+
+/**
+ * Verify that begin() loads the last snapshot with a
+ * valid crc and skips a torn one.
+ */
+unittest(wear_load)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+  auto miso = Wire.getMiso(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // take a valid snapshot from save()
+  for (int i = 0; i < 8 * 4; i++) miso->push_back(0xFF);
+  uint32_t counters[4];
+  I2C_eeprom_wear wear;
+  wear.begin(EE, counters, 4, 120, 8);
+  counters[1] = 1000;
+  mosi->clear();
+  wear.save();
+  uint8_t snapshot[21];
+  for (int i = 0; i < 5; i++) snapshot[i] = (*mosi)[20 + i];
+  for (int i = 0; i < 16; i++) snapshot[5 + i] = (*mosi)[2 + i];
+  wear.end();
+
+  // slot 0 holds the snapshot, slot 1 a torn one with seq 1
+  uint8_t seqs[8 * 4];
+  memset(seqs, 0xFF, sizeof(seqs));
+  memset(seqs, 0, 4);
+  memset(seqs + 4, 0, 4);
+  seqs[4] = 1;
+  for (int i = 0; i < 32; i++) miso->push_back(seqs[i]);
+  for (int i = 0; i < 5; i++) miso->push_back(i == 0 ? 1 : snapshot[i]);
+  for (int i = 0; i < 16; i++) miso->push_back(0x55);
+  for (int i = 0; i < 32; i++) miso->push_back(seqs[i]);
+  for (int i = 0; i < 21; i++) miso->push_back(snapshot[i]);
+
+  uint32_t loaded[4];
+  I2C_eeprom_wear wear2;
+  assertEqual(true, wear2.begin(EE, loaded, 4, 120, 8));
+  assertEqual(1000, wear2.getCount(1));
+  assertEqual(2, wear2.getCount(3));
+  assertEqual(0, miso->size());
+
+  // next save goes to slot 1 with seq 1
+  mosi->clear();
+  wear2.setSaveInterval(3);
+  assertEqual(true, wear2.poll());
+  assertEqual(0, mosi->size());
+  EE.writeByte(0, 1);
+  EE.writeByte(0, 1);
+  EE.writeByte(0, 1);
+  mosi->clear();
+  assertEqual(true, wear2.poll());
+  assertEqual(0x0F, (*mosi)[0]);
+  assertEqual(0x25, (*mosi)[1]);
+  assertEqual(1, (*mosi)[20]);
+}
+
+unittest_main()
+
+// --------
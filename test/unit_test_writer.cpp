@@ -0,0 +1,108 @@
+//
+//    FILE: unit_test_writer.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: unit tests for the I2C_eeprom_writer class of the I2C_EEPROM library
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+#include <ArduinoUnitTests.h>
+
+#include "Arduino.h"
+#include "I2C_eeprom.h"
+#include "I2C_eeprom_writer.h"
+
+#define I2C_EEPROM_ADDR 0x50
+#define I2C_EEPROM_SIZE 0x1000 // 4096, 32 byte pages
+
+unittest_setup()
+{
+}
+
+unittest_teardown()
+{
+}
+
+/**
+ * Verify that small appends are collected and only
+ * programmed once a page boundary is reached.
+ */
+unittest(writer_collects_page)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  // start 8 bytes before a page boundary
+  I2C_eeprom_writer writer(EE, 0x0018, 100);
+  for (int i = 0; i < 7; i++)
+  {
+    assertEqual(1, writer.write(i));
+  }
+  assertEqual(0, mosi->size());
+
+  // 8th byte completes the page => one write of 2 + 8 bytes
+  assertEqual(1, writer.write(7));
+  assertEqual(10, mosi->size());
+  assertEqual(0x00, (*mosi)[0]);
+  assertEqual(0x18, (*mosi)[1]);
+  assertEqual(0x0020, writer.position());
+
+  mosi->clear();
+  writer.write((const uint8_t *)"abc", 3);
+  assertEqual(0, mosi->size());
+  writer.flush();
+  assertEqual(5, mosi->size());
+  assertEqual(0x20, (*mosi)[1]);
+  assertEqual('a', (*mosi)[2]);
+}
+
+/**
+ * Verify that the writer does not pass the end of its region.
+ */
+unittest(writer_region_end)
+{
+  Wire.resetMocks();
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_EEPROM_SIZE);
+  EE.begin();
+
+  I2C_eeprom_writer writer(EE, 0x0000, 4);
+  assertEqual(4, writer.availableForWrite());
+  assertEqual(4, writer.write((const uint8_t *)"abcdef", 6));
+  assertEqual(0, writer.availableForWrite());
+  assertEqual(0, writer.write('g'));
+}
+
+/**
+ * Verify that a region at the top of a 64 KB device
+ * ends at 0x10000 instead of wrapping to 0.
+ */
+unittest(writer_device_end)
+{
+  Wire.resetMocks();
+
+  auto mosi = Wire.getMosi(I2C_EEPROM_ADDR);
+
+  I2C_eeprom EE(I2C_EEPROM_ADDR, I2C_DEVICESIZE_24LC512);
+  EE.begin();
+
+  I2C_eeprom_writer writer(EE, 0xFFF0, 16);
+  assertEqual(16, writer.availableForWrite());
+  assertEqual(16, writer.write((const uint8_t *)"0123456789abcdefgh", 18));
+  // last page chunk written at once
+  assertEqual(2 + 16, mosi->size());
+  assertEqual(0xFF, (*mosi)[0]);
+  assertEqual(0xF0, (*mosi)[1]);
+  assertEqual(0x10000, writer.position());
+  assertEqual(0, writer.availableForWrite());
+  assertEqual(0, writer.write('i'));
+  assertEqual(2 + 16, mosi->size());
+}
+
+unittest_main()
+
+// --------